@@ -25,12 +25,16 @@
 #include "login.h"
 #include "statustext.h"
 #include "sslservertrust.h"
+#include "qsvnactions/qsvnactionscheduler.h"
 #include "qsvnactions/qsvnclientcheckoutaction.h"
 
 //Qt
 #include <QtGui>
 
 
+//refresh rate of the message list in milliseconds
+#define REFRESH_INTERVAL 250
+
 Checkout::Checkout(QWidget *parent)
         : QDialog(0)
 {
@@ -47,10 +51,24 @@ Checkout::Checkout(QWidget *parent)
 
     editPath->setText(Config::instance()->value(KEY_LASTWC).toString());
 
+    comboDepth->addItem(tr("Fully recursive"), svn::DepthInfinity);
+    comboDepth->addItem(tr("Immediate children"), svn::DepthImmediates);
+    comboDepth->addItem(tr("Only file children"), svn::DepthFiles);
+    comboDepth->addItem(tr("Only this item"), svn::DepthEmpty);
+
     m_selectedURL = "";
     m_selectedPath = "";
     connect(buttonBox, SIGNAL(accepted()), this, SLOT(onDoCheckout()));
     buttonBox->button(QDialogButtonBox::Abort)->setVisible(false);
+
+    m_finishedActions = 0;
+    m_selectedRevision = svn::Revision::HEAD;
+    m_selectedDepth = svn::DepthInfinity;
+    m_notifyModel = new NotifyEntriesModel(this);
+    viewMessages->setModel(m_notifyModel);
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(REFRESH_INTERVAL);
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(onRefreshMessages()));
 }
 
 Checkout::~Checkout()
@@ -59,6 +77,18 @@ Checkout::~Checkout()
         Config::instance()->saveWidget(this, pageMessages->objectName());
     else
         Config::instance()->saveWidget(this, pageRepository->objectName());
+
+    //running actions stop at their next cancel check and delete themselves afterwards
+    for (int i = 0; i < m_actions.count(); ++i)
+    {
+        QSvnClientCheckoutAction *action = m_actions.at(i);
+        QSvnActionScheduler::instance()->cancel(m_jobIds.at(i));
+        connect(action, SIGNAL(finished()), action, SLOT(deleteLater()));
+        if (action->isRunning())
+            action->cancelAction();
+        else
+            action->deleteLater();
+    }
 }
 
 bool Checkout::checkInputs()
@@ -78,6 +108,13 @@ bool Checkout::checkInputs()
         return false;
     }
 
+    if (!readRevision(editRevision->text(), m_selectedRevision))
+    {
+        QMessageBox::critical(this, tr("QSvn - Error"), tr("You must specify a revision number or HEAD!"));
+        return false;
+    }
+    m_selectedDepth = svn::Depth(comboDepth->itemData(comboDepth->currentIndex()).toInt());
+
     m_selectedPath = removeTrailingDirSeparator(editPath->text());
     QDir dir(m_selectedPath);
     if (!dir.exists())
@@ -96,6 +133,31 @@ bool Checkout::checkInputs()
     return true;
 }
 
+bool Checkout::readRevision(const QString &text, svn::Revision &revision)
+{
+    if (text.trimmed().isEmpty() || text.trimmed().toUpper() == "HEAD")
+    {
+        revision = svn::Revision::HEAD;
+        return true;
+    }
+
+    bool ok;
+    uint revnum = text.trimmed().toUInt(&ok);
+    if (ok)
+        revision = svn::Revision(revnum);
+    return ok;
+}
+
+void Checkout::addCheckoutItem()
+{
+    QTreeWidgetItem *item = new QTreeWidgetItem(twCheckoutList);
+    item->setText(0, m_selectedURL);
+    item->setText(1, m_selectedPath);
+    item->setText(2, editRevision->text().trimmed().isEmpty() ? "HEAD" : editRevision->text().trimmed());
+    item->setText(3, comboDepth->currentText());
+    item->setData(3, Qt::UserRole, int(m_selectedDepth));
+}
+
 QString Checkout::removeTrailingDirSeparator(QString path)
 {
     while (path.endsWith(QDir::separator()))
@@ -113,10 +175,47 @@ void Checkout::on_buttonPath_clicked()
         editPath->setText(QDir::toNativeSeparators(directory));
 }
 
-void Checkout::onDoCheckout()
+void Checkout::on_buttonAddEntry_clicked()
 {
     if (!checkInputs())
         return;
+
+    //two checkouts into one directory would mix up their working copies
+    QString path = QDir::cleanPath(m_selectedPath);
+    for (int i = 0; i < twCheckoutList->topLevelItemCount(); ++i)
+    {
+        QTreeWidgetItem *item = twCheckoutList->topLevelItem(i);
+#if defined Q_WS_WIN32
+        bool samePath = QDir::cleanPath(item->text(1)).compare(path, Qt::CaseInsensitive) == 0;
+#else
+        bool samePath = QDir::cleanPath(item->text(1)) == path;
+#endif
+        if (samePath)
+        {
+            QMessageBox::critical(this, tr("QSvn - Error"),
+                                  QString(tr("The directory\n%1\nis already the target of\n%2"))
+                                          .arg(m_selectedPath).arg(item->text(0)));
+            return;
+        }
+    }
+    addCheckoutItem();
+    editURL->clearEditText();
+}
+
+void Checkout::on_buttonRemoveEntry_clicked()
+{
+    qDeleteAll(twCheckoutList->selectedItems());
+}
+
+void Checkout::onDoCheckout()
+{
+    //without a list, the entry fields are the only checkout
+    if (twCheckoutList->topLevelItemCount() == 0)
+    {
+        if (!checkInputs())
+            return;
+        addCheckoutItem();
+    }
     switchToPageMessages();
     saveInputValues();
 
@@ -124,28 +223,101 @@ void Checkout::onDoCheckout()
     buttonBox->button(QDialogButtonBox::Abort)->setVisible(true);
     buttonBox->button(QDialogButtonBox::Cancel)->setVisible(false);
     buttonBox->button(QDialogButtonBox::Ok)->setVisible(false);
+    connect(buttonBox->button(QDialogButtonBox::Abort), SIGNAL(clicked()), this, SLOT(onAbort()));
+
+    m_checkoutTime.start();
+    m_refreshTimer->start();
+    for (int i = 0; i < twCheckoutList->topLevelItemCount(); ++i)
+    {
+        QTreeWidgetItem *item = twCheckoutList->topLevelItem(i);
+        svn::Revision revision;
+        readRevision(item->text(2), revision);
+
+        QSvnClientCheckoutAction *action =
+                new QSvnClientCheckoutAction(item->text(0), item->text(1), revision,
+                                             svn::Depth(item->data(3, Qt::UserRole).toInt()));
+        connect(action, SIGNAL(notify(QString, QString)), this, SLOT(onNotify(QString, QString)));
+        connect(action, SIGNAL(finished()), this, SLOT(onActionFinished()));
+        connect(action, SIGNAL(finished(QString)), this, SIGNAL(finished(QString)));
+        connect(action, SIGNAL(doGetLogin(QString,QString,QString,bool)), this, SLOT(onGetLogin(QString,QString,QString,bool)));
+        connect(action, SIGNAL(doGetSslServerTrustPrompt()), this, SLOT(onGetSslServerTrustPrompt()));
+        m_actions << action;
+        m_jobIds << QSvnActionScheduler::instance()->enqueue(action, QSvnActionScheduler::Interactive,
+                                                             QUrl(item->text(0)).host(), item->text(1));
+    }
+}
 
-    action = new QSvnClientCheckoutAction(m_selectedURL, m_selectedPath);
-    connect(action, SIGNAL(notify(QString, QString)), this, SLOT(onNotify(QString, QString)));
-    connect(action, SIGNAL(finished()), this, SLOT(onCheckoutFinished()));
-    connect(action, SIGNAL(finished(QString)), this, SIGNAL(finished(QString)));
-    connect(action, SIGNAL(doGetLogin(QString,QString,QString,bool)), this, SLOT(onGetLogin(QString,QString,QString,bool)));
-    connect(action, SIGNAL(doGetSslServerTrustPrompt()), this, SLOT(onGetSslServerTrustPrompt()));
-    connect(buttonBox->button(QDialogButtonBox::Abort), SIGNAL(clicked()), action, SLOT(cancelAction()));
-    action->start();
+void Checkout::onAbort()
+{
+    for (int i = 0; i < m_actions.count(); ++i)
+    {
+        if (QSvnActionScheduler::instance()->cancel(m_jobIds.at(i)))
+            ++m_finishedActions;
+        else if (m_actions.at(i)->isRunning())
+            m_actions.at(i)->cancelAction();
+    }
+    if (m_finishedActions == m_actions.count())
+        onCheckoutFinished();
+}
+
+void Checkout::onActionFinished()
+{
+    if (++m_finishedActions == m_actions.count())
+        onCheckoutFinished();
 }
 
 void Checkout::onNotify(QString action, QString path)
 {
-    QTreeWidgetItem *item = new QTreeWidgetItem(twMessages);
-    item->setText(0, action);
-    item->setText(1, path);
-    twMessages->addTopLevelItem(item);
-    twMessages->scrollToItem(item);
+    m_pendingEntries.append(NotifyEntry(action, path));
+}
+
+void Checkout::onRefreshMessages()
+{
+    if (!m_pendingEntries.isEmpty())
+    {
+        //only follow the new entries, if the user doesn't scroll back
+        QScrollBar *scrollBar = viewMessages->verticalScrollBar();
+        bool autoScroll = scrollBar->value() == scrollBar->maximum();
+
+        m_notifyModel->appendEntries(m_pendingEntries);
+        m_pendingEntries.clear();
+
+        if (autoScroll)
+            viewMessages->scrollToBottom();
+    }
+    updateSummary();
+}
+
+void Checkout::updateSummary()
+{
+    double seconds = qMax(m_checkoutTime.elapsed(), 1) / 1000.0;
+    qlonglong bytes = 0;
+    foreach (QSvnClientCheckoutAction *action, m_actions)
+        bytes += action->transferredBytes();
+    double megaBytes = bytes / (1024.0 * 1024.0);
+    int items = m_notifyModel->rowCount();
+
+    QStringList counts;
+    QHashIterator<QString, int> it(m_notifyModel->actionCounts());
+    while (it.hasNext())
+    {
+        it.next();
+        counts << QString("%1: %2").arg(it.key()).arg(it.value());
+    }
+    counts.sort();
+
+    labelSummary->setText(tr("%1 items (%2 items/s), %3 MB (%4 MB/s)\n%5")
+            .arg(items)
+            .arg(items / seconds, 0, 'f', 1)
+            .arg(megaBytes, 0, 'f', 2)
+            .arg(megaBytes / seconds, 0, 'f', 2)
+            .arg(counts.join(", ")));
 }
 
 void Checkout::onCheckoutFinished()
 {
+    m_refreshTimer->stop();
+    onRefreshMessages();
     buttonBox->button(QDialogButtonBox::Ok)->setVisible(true);
     buttonBox->button(QDialogButtonBox::Abort)->setVisible(false);
     disconnect(buttonBox, SIGNAL(accepted()), this, SLOT(onDoCheckout()));
@@ -154,6 +326,10 @@ void Checkout::onCheckoutFinished()
 
 void Checkout::onGetLogin(QString realm, QString username, QString password, bool maySave)
 {
+    QSvnClientCheckoutAction *action = qobject_cast<QSvnClientCheckoutAction*>(sender());
+    if (!action)
+        return;
+
     if (Login::doLogin(this, realm, username, password, maySave))
         action->endGetLogin(username, password, maySave);
     else
@@ -162,6 +338,10 @@ void Checkout::onGetLogin(QString realm, QString username, QString password, boo
 
 void Checkout::onGetSslServerTrustPrompt()
 {
+    QSvnClientCheckoutAction *action = qobject_cast<QSvnClientCheckoutAction*>(sender());
+    if (!action)
+        return;
+
     action->endGetSslServerTrustPrompt(SslServerTrust::getSslServerTrustAnswer(action->getSslServerTrustData()));
 }
 
@@ -178,7 +358,12 @@ void Checkout::saveInputValues()
 void Checkout::switchToPageMessages()
 {
     Config::instance()->saveWidget(this, pageRepository->objectName());
-    labelMessages->setText(QString("%1 \n into \n %2").arg(m_selectedURL).arg(m_selectedPath));
+    QStringList checkouts;
+    for (int i = 0; i < twCheckoutList->topLevelItemCount(); ++i)
+        checkouts << QString("%1 \n into \n %2")
+                .arg(twCheckoutList->topLevelItem(i)->text(0))
+                .arg(twCheckoutList->topLevelItem(i)->text(1));
+    labelMessages->setText(checkouts.join("\n"));
     stackedWidget->setCurrentWidget(pageMessages);
     Config::instance()->restoreWidget(this, pageMessages->objectName());
 }
@@ -22,6 +22,7 @@
 #define CHECKOUT_H
 
 //QSvn
+#include "notifyentriesmodel.h"
 #include "ui_checkout.h"
 
 //QSvnActions
@@ -29,8 +30,11 @@
 
 //Qt
 #include <QDialog>
+#include <QTime>
 #include <svn_wc.h>
 
+class QTimer;
+
 
 class Checkout : public QDialog, public Ui::Checkout
 {
@@ -42,6 +46,8 @@ class Checkout : public QDialog, public Ui::Checkout
 
     public slots:
         void on_buttonPath_clicked();
+        void on_buttonAddEntry_clicked();
+        void on_buttonRemoveEntry_clicked();
         void onDoCheckout();
         void onCheckoutFinished();
         void onNotify(QString action, QString path);
@@ -51,15 +57,34 @@ class Checkout : public QDialog, public Ui::Checkout
                         bool  maySave);
         void onGetSslServerTrustPrompt();
 
+    private slots:
+        void onRefreshMessages();
+        void onAbort();
+        void onActionFinished();
+
     private:
-        QSvnClientCheckoutAction *action;
+        //one action per entry of twCheckoutList, all run through the scheduler
+        QList<QSvnClientCheckoutAction*> m_actions;
+        QList<int> m_jobIds;
+        int m_finishedActions;
         QString m_selectedURL;
         QString m_selectedPath;
+        svn::Revision m_selectedRevision;
+        svn::Depth m_selectedDepth;
+
+        //notifications are collected and shown in batches
+        NotifyEntriesModel *m_notifyModel;
+        QList<NotifyEntry> m_pendingEntries;
+        QTimer *m_refreshTimer;
+        QTime m_checkoutTime;
 
         bool checkInputs();
+        bool readRevision(const QString &text, svn::Revision &revision);
+        void addCheckoutItem();
         QString removeTrailingDirSeparator(QString path);
         void switchToPageMessages();
         void saveInputValues();
+        void updateSummary();
 
     signals:
         void finished(QString);
@@ -27,9 +27,19 @@
 #include <QtGui>
 
 
+//delay in milliseconds before changed values are written to disk
+#define FLUSH_DELAY 500
+
+
 //make Config a singleton
 Config* Config::m_instance = 0;
 
+//QApplication calls it on destruction, after the main window and its models saved their values
+static void flushConfig()
+{
+    Config::instance()->flush();
+}
+
 Config* Config::instance()
 {
     if (m_instance == 0)
@@ -47,6 +57,23 @@ Config::Config(QObject *parent)
 
     m_tempDir = QDir::tempPath() + QDir::separator() + "qsvn" + QDir::separator();
     m_tempDir = QDir::toNativeSeparators(m_tempDir);
+
+    m_flushTimer = new QTimer(this);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_DELAY);
+    connect(m_flushTimer, SIGNAL(timeout()), this, SLOT(flush()));
+    if (qApp)
+    {
+        connect(qApp, SIGNAL(aboutToQuit()), this, SLOT(flush()));
+        //the event loop and the timer are gone when destructors save their values
+        qAddPostRoutine(flushConfig);
+    }
+
+    m_watcher = new QFileSystemWatcher(this);
+    connect(m_watcher, SIGNAL(fileChanged(const QString &)), this, SLOT(onIniFileChanged(const QString &)));
+
+    load();
+    watchIniFile();
 }
 
 void Config::removeTempDir()
@@ -61,11 +88,124 @@ void Config::removeTempDir()
 
 void Config::setIniFile(const QString iniFile)
 {
+    flush();
+    if (!m_watcher->files().isEmpty())
+        m_watcher->removePaths(m_watcher->files());
+
     if (m_settings)
         delete(m_settings);
 
     m_settings = new QSettings(iniFile, QSettings::IniFormat, this);
+    load();
+    watchIniFile();
+}
+
+void Config::load()
+{
+    m_settings->sync();
+    m_values.clear();
+    foreach (QString key, m_settings->allKeys())
+        m_values.insert(key, m_settings->value(key));
+}
+
+void Config::watchIniFile()
+{
+    //QSettings replaces the file when it writes, so the watch has to be renewed
+    QString fileName = m_settings->fileName();
+    if (QFile::exists(fileName) && !m_watcher->files().contains(fileName))
+        m_watcher->addPath(fileName);
+}
+
+void Config::flush()
+{
+    m_flushTimer->stop();
+    if (m_dirtyKeys.isEmpty() && m_removedKeys.isEmpty())
+        return;
+
+    foreach (QString key, m_removedKeys)
+        m_settings->remove(key);
+    foreach (QString key, m_dirtyKeys)
+        m_settings->setValue(key, m_values.value(key));
     m_settings->sync();
+
+    m_dirtyKeys.clear();
+    m_removedKeys.clear();
+    m_lastFlush = QFileInfo(m_settings->fileName()).lastModified();
+    watchIniFile();
+}
+
+void Config::onIniFileChanged(const QString &fileName)
+{
+    watchIniFile();
+
+    //ignore our own writes
+    QDateTime lastModified = QFileInfo(fileName).lastModified();
+    if (!lastModified.isValid() || lastModified == m_lastFlush)
+        return;
+    m_lastFlush = lastModified;
+
+    //reload, but keep the changes that are not written yet
+    QHash<QString, QVariant> dirtyValues;
+    foreach (QString key, m_dirtyKeys)
+        dirtyValues.insert(key, m_values.value(key));
+
+    load();
+    foreach (QString key, m_removedKeys)
+        removeGroup(key);
+    QHashIterator<QString, QVariant> it(dirtyValues);
+    while (it.hasNext())
+    {
+        it.next();
+        writeValue(it.key(), it.value());
+    }
+}
+
+void Config::writeValue(const QString &key, const QVariant &value)
+{
+    m_values.insert(key, value);
+    m_dirtyKeys.insert(key);
+    m_removedKeys.remove(key);
+    m_flushTimer->start();
+}
+
+QVariant Config::readValue(const QString &key, const QVariant &defaultValue) const
+{
+    return m_values.value(key, defaultValue);
+}
+
+void Config::removeGroup(const QString &prefix)
+{
+    QString group = prefix + "/";
+    QMutableHashIterator<QString, QVariant> it(m_values);
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.key() == prefix || it.key().startsWith(group))
+        {
+            m_dirtyKeys.remove(it.key());
+            it.remove();
+        }
+    }
+    //QSettings::remove() removes the whole group
+    m_removedKeys.insert(prefix);
+    m_flushTimer->start();
+}
+
+void Config::writeArray(const QString &prefix, const QString &entry, const QVariantList &values)
+{
+    removeGroup(prefix);
+    for (int i = 0; i < values.count(); ++i)
+        writeValue(QString("%1/%2/%3").arg(prefix).arg(i + 1).arg(entry), values.at(i));
+    writeValue(prefix + "/size", values.count());
+}
+
+QVariantList Config::readArray(const QString &prefix, const QString &entry) const
+{
+    QVariantList values;
+    int size = readValue(prefix + "/size", 0).toInt();
+    for (int i = 0; i < size; ++i)
+        values.append(readValue(QString("%1/%2/%3").arg(prefix).arg(i + 1).arg(entry), QVariant()));
+    return values;
 }
 
 void Config::saveMainWindow(const QSvn *aQSvn)
@@ -94,56 +234,38 @@ void Config::saveWidget(const QWidget *widget, const QString prefix)
 {
     QString key = "widget" + prefix + widget->objectName();
 
-    m_settings->sync();
-    m_settings->remove(key);
-    m_settings->setValue(key + "/geometry", widget->saveGeometry());
-    m_settings->sync();
+    removeGroup(key);
+    writeValue(key + "/geometry", widget->saveGeometry());
 }
 
 void Config::restoreWidget(QWidget *widget, const QString prefix)
 {
     QString key = "widget" + prefix + widget->objectName();
 
-    m_settings->sync();
-    widget->restoreGeometry(m_settings->value(key + "/geometry").toByteArray());
+    widget->restoreGeometry(readValue(key + "/geometry", QVariant()).toByteArray());
 }
 
 void Config::saveSplitter(const QObject *parent, const QSplitter *splitter)
 {
     QString key = parent->objectName() + "_" + splitter->objectName();
 
-    m_settings->sync();
-    m_settings->remove(key);
-    m_settings->beginWriteArray(key, splitter->sizes().count());
-    for (int i = 0; i < splitter->sizes().count(); ++i)
-    {
-        m_settings->setArrayIndex(i);
-        m_settings->setValue("value", splitter->sizes().at(i));
-    }
-    m_settings->endArray();
-    m_settings->sync();
+    QVariantList sizes;
+    foreach (int size, splitter->sizes())
+        sizes.append(size);
+    writeArray(key, "value", sizes);
 }
 
 void Config::restoreSplitter(const QObject *parent, QSplitter *splitter)
 {
     QString key = parent->objectName() + "_" + splitter->objectName();
 
-    m_settings->sync();
-    int size = m_settings->beginReadArray(key);
-    if (size <= 0)
-    {
-        m_settings->endArray();
+    QVariantList sizes = readArray(key, "value");
+    if (sizes.isEmpty())
         return;
-    }
 
     QList<int> list = splitter->sizes();
-    for (int i = 0; i < size; i++)
-    {
-        m_settings->setArrayIndex(i);
-        list.replace(i, m_settings->value("value").toInt());
-    }
-    m_settings->endArray();
-    m_settings->sync();
+    for (int i = 0; i < sizes.count() && i < list.count(); i++)
+        list.replace(i, sizes.at(i).toInt());
 
     splitter->setSizes(list);
 }
@@ -153,93 +275,63 @@ void Config::saveStringList(const QString &prefix, const QStringList &stringList
     if (prefix.isEmpty())
         return;
 
-    m_settings->sync();
-    m_settings->remove(prefix);
-    m_settings->beginWriteArray(prefix, stringList.count());
-    for (int i = 0; i < stringList.count(); ++i)
-    {
-        m_settings->setArrayIndex(i);
-        m_settings->setValue("entry" , stringList.at(i));
-    }
-    m_settings->endArray();
-    m_settings->sync();
+    QVariantList entries;
+    foreach (QString string, stringList)
+        entries.append(string);
+    writeArray(prefix, "entry", entries);
 }
 
 QStringList Config::getStringList(const QString &prefix)
 {
     QStringList stringList;
-
-    m_settings->sync();
-    int size = m_settings->beginReadArray(prefix);
-
-    for (int i = 0; i < size; ++i)
-    {
-        m_settings->setArrayIndex(i);
-        stringList.append(m_settings->value("entry").toString());
-    }
-    m_settings->endArray();
-    m_settings->sync();
-
+    foreach (QVariant entry, readArray(prefix, "entry"))
+        stringList.append(entry.toString());
     return stringList;
 }
 
 void Config::setValue(const QString &key, const QVariant &value)
 {
-    m_settings->sync();
-    m_settings->setValue(key, value);
-    m_settings->sync();
+    writeValue(key, value);
 }
 
 QVariant Config::value(const QString &key)
 {
-    m_settings->sync();
-    return m_settings->value(key, defaultValue(key));
-    m_settings->sync();
+    return readValue(key, defaultValue(key));
 }
 
 QVariant Config::value(const QString & key, const QVariant & defaultValue)
 {
-    m_settings->sync();
-    return m_settings->value(key, defaultValue);
-    m_settings->sync();
+    return readValue(key, defaultValue);
 }
 
 void Config::saveHeaderView(const QObject *parent, const QHeaderView *headerView)
 {
     QString key = parent->objectName() + "_" + headerView->parent()->objectName();
 
-    m_settings->sync();
-    m_settings->remove(key);
-    m_settings->beginWriteArray(key, headerView->count());
+    QVariantList sizes;
     for (int i = 0; i < headerView->count(); ++i)
-    {
-        m_settings->setArrayIndex(i);
-        m_settings->setValue("value", headerView->sectionSize(i));
-    }
-    m_settings->endArray();
+        sizes.append(headerView->sectionSize(i));
+    writeArray(key, "value", sizes);
+
     key = key + "_sort";
-    m_settings->setValue(key + "/section", headerView->sortIndicatorSection());
-    m_settings->setValue(key + "/order",   QVariant(headerView->sortIndicatorOrder()));
-    m_settings->sync();
+    writeValue(key + "/section", headerView->sortIndicatorSection());
+    writeValue(key + "/order",   QVariant(headerView->sortIndicatorOrder()));
 }
 
 void Config::restoreHeaderView(const QObject *parent, QHeaderView *headerView)
 {
     QString key = parent->objectName() + "_" + headerView->parent()->objectName();
 
-    m_settings->sync();
-    m_settings->beginReadArray(key);
+    QVariantList sizes = readArray(key, "value");
     for (int i = 0; i < headerView->count(); i++)
     {
-        m_settings->setArrayIndex(i);
-        headerView->resizeSection(i, m_settings->value("value", headerView->sectionSize(i)).toInt());
+        if (i < sizes.count() && sizes.at(i).isValid())
+            headerView->resizeSection(i, sizes.at(i).toInt());
     }
-    m_settings->endArray();
 
     key = key + "_sort";
-    headerView->setSortIndicator(m_settings->value(key + "/section", headerView->sortIndicatorSection()).toInt(),
-                                 Qt::SortOrder(m_settings->value(key + "/order", headerView->sortIndicatorSection()).toInt()));
-    m_settings->sync();
+    headerView->setSortIndicator(readValue(key + "/section", headerView->sortIndicatorSection()).toInt(),
+                                 Qt::SortOrder(readValue(key + "/order", headerView->sortIndicatorSection()).toInt()));
 }
 
 QString Config::tempDir()
@@ -256,6 +348,8 @@ QVariant Config::defaultValue(const QString &key)
         return true;
     else if (key == KEY_CHECKEMPTYLOGMESSAGE)
         return true;
+    else if (key == KEY_COMBINEDFILESELECTOR)
+        return true;
     else if (key == KEY_LASTWC)
         return QDir::toNativeSeparators(QDir::homePath());
     else
@@ -26,7 +26,13 @@
 class QSvn;
 
 //Qt
+#include <QDateTime>
+#include <QHash>
 #include <QObject>
+#include <QSet>
+#include <QVariant>
+
+class QFileSystemWatcher;
 
 class QHeaderView;
 
@@ -34,6 +40,8 @@ class QSettings;
 
 class QSplitter;
 
+class QTimer;
+
 
 //configuration strings
 #define KEY_DIFFVIEWER "configuration/diffViewer"
@@ -41,6 +49,8 @@ class QSplitter;
 #define KEY_CHECKEMPTYLOGMESSAGE "configuration/checkEmptyLogMessage"
 #define KEY_SHOWTEXTINTOOLBAR "configuration/checkShowTextInToolbar"
 #define KEY_ICONSIZE "configuration/iconSize"
+#define KEY_WATCHERIGNORE "configuration/watcherIgnore"
+#define KEY_COMBINEDFILESELECTOR "configuration/combinedFileSelector"
 #define KEY_LASTWC "lastWC"
 
 #define KEY_LASTMERGEWC "merge/%1_wc"
@@ -54,6 +64,11 @@ class QSplitter;
 /**
 this singelton holds the configuration for qsvn
 
+All values are held in memory. Changes are written to disk delayed
+by a timer and at shutdown, values saved by destructors after the
+event loop ended are written when the application is destroyed.
+The ini file is only read again when it was changed by someone else.
+
 @author Andreas Richter
 */
 
@@ -99,6 +114,15 @@ class Config : public QObject
 
         void setIniFile(const QString iniFile);
 
+    public slots:
+        /**
+         * Write all changed values to disk.
+         */
+        void flush();
+
+    private slots:
+        void onIniFileChanged(const QString &fileName);
+
     private:
         Config(QObject *parent = 0);
 
@@ -106,6 +130,22 @@ class Config : public QObject
         QSettings *m_settings;
         QString m_tempDir;
 
+        QHash<QString, QVariant> m_values;
+        QSet<QString> m_dirtyKeys;
+        QSet<QString> m_removedKeys;
+        QTimer *m_flushTimer;
+        QFileSystemWatcher *m_watcher;
+        QDateTime m_lastFlush;
+
+        void load();
+        void watchIniFile();
+        void writeValue(const QString &key, const QVariant &value);
+        QVariant readValue(const QString &key, const QVariant &defaultValue) const;
+        void removeGroup(const QString &prefix);
+        //arrays use the same keys as QSettings::beginWriteArray
+        void writeArray(const QString &prefix, const QString &entry, const QVariantList &values);
+        QVariantList readArray(const QString &prefix, const QString &entry) const;
+
 
         QVariant defaultValue(const QString &key); //returns default values for configuration parameters
 };
@@ -42,8 +42,10 @@ Configure::Configure(QWidget *parent, Qt::WFlags flags)
     editDiffViewer->setText(Config::instance()->value(KEY_DIFFVIEWER).toString());
     checkBoxShowLogAfterUpdate->setChecked(Config::instance()->value(KEY_SHOWLOGAFTERUPDATE).toBool());
     checkBoxCheckEmptyLogMessage->setChecked(Config::instance()->value(KEY_CHECKEMPTYLOGMESSAGE).toBool());
+    checkBoxCombinedFileSelector->setChecked(Config::instance()->value(KEY_COMBINEDFILESELECTOR).toBool());
     checkBoxShowTextInToolbar->setChecked(Config::instance()->value(KEY_SHOWTEXTINTOOLBAR).toBool());
     comboBoxIconsize->setCurrentIndex(comboBoxIconsize->findData(Config::instance()->value(KEY_ICONSIZE, DEFAULT_ICONSIZE).toInt()));
+    editWatcherIgnore->setText(Config::instance()->value(KEY_WATCHERIGNORE).toString());
 }
 
 Configure::~Configure()
@@ -56,8 +58,10 @@ void Configure::accept()
     Config::instance()->setValue(KEY_DIFFVIEWER, editDiffViewer->text());
     Config::instance()->setValue(KEY_SHOWLOGAFTERUPDATE, checkBoxShowLogAfterUpdate->checkState());
     Config::instance()->setValue(KEY_CHECKEMPTYLOGMESSAGE, checkBoxCheckEmptyLogMessage->checkState());
+    Config::instance()->setValue(KEY_COMBINEDFILESELECTOR, checkBoxCombinedFileSelector->checkState());
     Config::instance()->setValue(KEY_SHOWTEXTINTOOLBAR, checkBoxShowTextInToolbar->checkState());
     Config::instance()->setValue(KEY_ICONSIZE, comboBoxIconsize->itemData(comboBoxIconsize->currentIndex()));
+    Config::instance()->setValue(KEY_WATCHERIGNORE, editWatcherIgnore->text());
     QDialog::accept();
 }
 
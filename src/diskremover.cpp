@@ -0,0 +1,415 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "diskremover.h"
+#include "diskremover.moc"
+
+//Qt
+#include <QtCore>
+
+#if defined Q_OS_UNIX
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//interval for the progress signal in milliseconds
+#define PROGRESS_INTERVAL 250
+
+
+//DiskRemoverWorker
+DiskRemoverWorker::DiskRemoverWorker(DiskRemover *remover)
+    : QThread()
+{
+    m_remover = remover;
+}
+
+void DiskRemoverWorker::run()
+{
+#if defined Q_OS_UNIX
+    //subdirectories are removed depth first from an own stack, idle workers get a share of it
+    QList<DiskRemover::Directory*> stack;
+    while (DiskRemover::Directory *directory = m_remover->nextDirectory(stack))
+        m_remover->removeDirectory(directory, stack);
+#endif
+}
+
+
+//DiskRemover
+DiskRemover::DiskRemover(QObject *parent, const QStringList &paths, bool moveToTrash)
+    : QThread(parent)
+{
+    m_paths = paths;
+    m_moveToTrash = moveToTrash;
+    m_idleWorkers = 0;
+    m_workers = 0;
+    m_done = false;
+}
+
+DiskRemover::~DiskRemover()
+{
+    cancel();
+    wait();
+}
+
+bool DiskRemover::removeFromDisk(const QString &path)
+{
+    DiskRemover remover(0, QStringList(path));
+    remover.run();
+    return remover.failedPaths().isEmpty();
+}
+
+int DiskRemover::removedEntries()
+{
+    return m_removed;
+}
+
+QStringList DiskRemover::failedPaths()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_failedPaths;
+}
+
+QStringList DiskRemover::trashPaths()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_trashPaths;
+}
+
+bool DiskRemover::isCanceled()
+{
+    return m_canceled != 0;
+}
+
+void DiskRemover::cancel()
+{
+    QMutexLocker locker(&m_mutex);
+    m_canceled = 1;
+    m_wakeUp.wakeAll();
+}
+
+void DiskRemover::run()
+{
+    QStringList roots;
+    foreach (QString path, m_paths)
+    {
+        QFileInfo fileInfo(path);
+        if (!fileInfo.exists() && !fileInfo.isSymLink())
+            continue;
+
+        QString root = QDir::cleanPath(fileInfo.absoluteFilePath());
+        if (m_moveToTrash)
+        {
+            QString trash = trashPath(root);
+            if (QDir().rename(root, trash))
+            {
+                root = trash;
+                QMutexLocker locker(&m_mutex);
+                m_trashPaths << trash;
+            }
+        }
+        roots << root;
+    }
+
+#if defined Q_OS_UNIX
+    foreach (QString root, roots)
+    {
+        QFileInfo fileInfo(root);
+        QByteArray encodedRoot = QFile::encodeName(root);
+        if (!fileInfo.isDir() || fileInfo.isSymLink())
+        {
+            if (::unlink(encodedRoot.constData()) == 0)
+                m_removed.ref();
+            else
+                addFailedPath(encodedRoot);
+            continue;
+        }
+
+        Directory *directory = new Directory;
+        directory->parent = 0;
+        directory->parentFd = ::open(QFile::encodeName(fileInfo.absolutePath()).constData(), O_RDONLY | O_DIRECTORY);
+        directory->fd = -1;
+        directory->name = QFile::encodeName(fileInfo.fileName());
+        directory->path = encodedRoot;
+        directory->pending = 1;
+        if (directory->parentFd < 0)
+        {
+            addFailedPath(encodedRoot);
+            delete directory;
+            continue;
+        }
+        m_queue << directory;
+        m_directories.insert(directory);
+    }
+
+    m_workers = qMax(1, QThread::idealThreadCount());
+    QList<DiskRemoverWorker*> workers;
+    for (int i = 0; i < m_workers; ++i)
+    {
+        workers << new DiskRemoverWorker(this);
+        workers.last()->start();
+    }
+    foreach (DiskRemoverWorker *worker, workers)
+    {
+        while (!worker->wait(PROGRESS_INTERVAL))
+            emit progress(m_removed);
+    }
+    qDeleteAll(workers);
+
+    //after a cancel, unfinished directories are left
+    foreach (Directory *directory, m_directories)
+    {
+        if (directory->fd >= 0)
+            ::close(directory->fd);
+        if (!directory->parent && directory->parentFd >= 0)
+            ::close(directory->parentFd);
+        delete directory;
+    }
+    m_directories.clear();
+    m_queue.clear();
+#else
+    foreach (QString root, roots)
+    {
+        if (m_canceled)
+            break;
+        removeRecursive(root);
+    }
+#endif
+    emit progress(m_removed);
+}
+
+QString DiskRemover::trashPath(const QString &path)
+{
+    //a hidden sibling, a rename on the same file system is atomic
+    QFileInfo fileInfo(path);
+    for (int i = 0; ; ++i)
+    {
+        QString trash = QString("%1/.%2.qsvn-trash-%3").arg(fileInfo.absolutePath()).arg(fileInfo.fileName()).arg(i);
+        if (!QFileInfo(trash).exists())
+            return trash;
+    }
+}
+
+void DiskRemover::addFailedPath(const QByteArray &path)
+{
+    QMutexLocker locker(&m_mutex);
+    m_failedPaths << QFile::decodeName(path);
+}
+
+bool DiskRemover::removeRecursive(const QString &path)
+{
+    bool result = true;
+    QDir dir = QDir(path);
+    dir.setFilter(QDir::NoDotAndDotDot | QDir::Files | QDir::Hidden | QDir::Dirs | QDir::System);
+    foreach (QFileInfo fileInfo, dir.entryInfoList())
+    {
+        if (m_canceled)
+            return false;
+
+        if (fileInfo.isDir() && !fileInfo.isSymLink())
+        {
+            result &= removeRecursive(fileInfo.filePath());
+        }
+        else
+        {
+            //files in .svn are read only
+            QFile::setPermissions(fileInfo.filePath(), QFile::WriteOwner | QFile::ReadOwner);
+            if (QFile::remove(fileInfo.filePath()))
+                m_removed.ref();
+            else
+            {
+                addFailedPath(QFile::encodeName(fileInfo.filePath()));
+                result = false;
+            }
+        }
+    }
+
+    if (dir.rmdir(path))
+        m_removed.ref();
+    else
+    {
+        addFailedPath(QFile::encodeName(path));
+        result = false;
+    }
+    return result;
+}
+
+#if defined Q_OS_UNIX
+DiskRemover::Directory *DiskRemover::nextDirectory(QList<Directory*> &stack)
+{
+    if (m_canceled)
+        return 0;
+
+    if (!stack.isEmpty())
+    {
+        shareDirectories(stack);
+        return stack.takeLast();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    while (true)
+    {
+        if (m_canceled || m_done)
+            return 0;
+        if (!m_queue.isEmpty())
+            return m_queue.takeFirst();
+
+        //all workers idle and nothing left, the trees are removed
+        if (m_idleWorkers.fetchAndAddOrdered(1) + 1 == m_workers)
+        {
+            m_done = true;
+            m_wakeUp.wakeAll();
+            return 0;
+        }
+        m_wakeUp.wait(&m_mutex);
+        m_idleWorkers.deref();
+    }
+}
+
+void DiskRemover::shareDirectories(QList<Directory*> &stack)
+{
+    //the bottom of the stack holds the biggest subtrees
+    if (stack.count() < 2 || m_idleWorkers == 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+    if (m_idleWorkers == 0)
+        return;
+    int count = stack.count() / 2;
+    for (int i = 0; i < count; ++i)
+        m_queue << stack.takeFirst();
+    m_wakeUp.wakeAll();
+}
+
+void DiskRemover::removeDirectory(Directory *directory, QList<Directory*> &stack)
+{
+    int parentFd = directory->parent ? directory->parent->fd : directory->parentFd;
+    directory->fd = ::openat(parentFd, directory->name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    if (directory->fd < 0 && errno == EACCES)
+    {
+        ::fchmodat(parentFd, directory->name.constData(), S_IRWXU, 0);
+        directory->fd = ::openat(parentFd, directory->name.constData(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW);
+    }
+    if (directory->fd < 0)
+    {
+        finishDirectory(directory);
+        return;
+    }
+
+    int listFd = ::dup(directory->fd);
+    DIR *dir = listFd < 0 ? 0 : ::fdopendir(listFd);
+    if (!dir)
+    {
+        if (listFd >= 0)
+            ::close(listFd);
+        finishDirectory(directory);
+        return;
+    }
+
+    bool madeWritable = false;
+    struct dirent *entry;
+    while (!m_canceled && (entry = ::readdir(dir)) != 0)
+    {
+        const char *name = entry->d_name;
+        if (strcmp(name, ".") == 0 || strcmp(name, "..") == 0)
+            continue;
+
+        bool isDir = entry->d_type == DT_DIR;
+        if (entry->d_type == DT_UNKNOWN)
+        {
+            struct stat status;
+            if (::fstatat(directory->fd, name, &status, AT_SYMLINK_NOFOLLOW) == 0)
+                isDir = S_ISDIR(status.st_mode);
+        }
+
+        if (isDir)
+        {
+            Directory *child = new Directory;
+            child->parent = directory;
+            child->parentFd = -1;
+            child->fd = -1;
+            child->name = name;
+            child->path = directory->path + '/' + name;
+            child->pending = 1;
+            directory->pending.ref();
+            m_mutex.lock();
+            m_directories.insert(child);
+            m_mutex.unlock();
+            stack << child;
+            continue;
+        }
+
+        int result = ::unlinkat(directory->fd, name, 0);
+        if (result != 0 && (errno == EACCES || errno == EPERM) && !madeWritable)
+        {
+            ::fchmod(directory->fd, S_IRWXU);
+            madeWritable = true;
+            result = ::unlinkat(directory->fd, name, 0);
+        }
+        if (result == 0)
+            m_removed.ref();
+        else
+            addFailedPath(directory->path + '/' + name);
+    }
+    ::closedir(dir);
+    finishDirectory(directory);
+}
+
+void DiskRemover::finishDirectory(Directory *directory)
+{
+    //the last finished subdirectory removes its parent
+    while (directory && !directory->pending.deref())
+    {
+        if (m_canceled)
+            return;
+
+        Directory *parent = directory->parent;
+        int parentFd = parent ? parent->fd : directory->parentFd;
+        if (directory->fd >= 0)
+        {
+            ::close(directory->fd);
+            directory->fd = -1;
+        }
+
+        int result = ::unlinkat(parentFd, directory->name.constData(), AT_REMOVEDIR);
+        if (result != 0 && (errno == EACCES || errno == EPERM) && parent)
+        {
+            ::fchmod(parentFd, S_IRWXU);
+            result = ::unlinkat(parentFd, directory->name.constData(), AT_REMOVEDIR);
+        }
+        if (result == 0)
+            m_removed.ref();
+        else
+            addFailedPath(directory->path);
+
+        if (!parent)
+            ::close(directory->parentFd);
+        m_mutex.lock();
+        m_directories.remove(directory);
+        m_mutex.unlock();
+        delete directory;
+        directory = parent;
+    }
+}
+#endif
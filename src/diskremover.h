@@ -0,0 +1,117 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef DISKREMOVER_H
+#define DISKREMOVER_H
+
+#include <QtCore>
+
+class DiskRemover;
+
+
+/**
+Removes the directories handed out by a DiskRemover.
+*/
+class DiskRemoverWorker : public QThread
+{
+    public:
+        DiskRemoverWorker(DiskRemover *remover);
+
+    protected:
+        void run();
+
+    private:
+        DiskRemover *m_remover;
+};
+
+
+/**
+Removes directory trees from the disk in a background thread. The trees are
+walked with directory file descriptors and several workers remove subtrees
+in parallel. With moveToTrash, every tree is renamed first, so it is gone
+from its place at once.
+*/
+class DiskRemover : public QThread
+{
+        Q_OBJECT
+
+        friend class DiskRemoverWorker;
+
+    public:
+        DiskRemover(QObject *parent, const QStringList &paths, bool moveToTrash = false);
+        ~DiskRemover();
+
+        /**
+         * Remove path and everything below it, returns when done.
+         */
+        static bool removeFromDisk(const QString &path);
+
+        int removedEntries();
+        QStringList failedPaths();
+        QStringList trashPaths(); //renamed trees, left on the disk after a cancel or an error
+        bool isCanceled();
+
+    public slots:
+        void cancel();
+
+    signals:
+        void progress(int removedEntries);
+
+    protected:
+        void run();
+
+    private:
+        //a directory, open as long as it is read or has subdirectories left
+        struct Directory
+        {
+            Directory *parent;
+            int parentFd; //for the roots
+            int fd;
+            QByteArray name;
+            QByteArray path;
+            QAtomicInt pending; //own listing and unfinished subdirectories
+        };
+
+        QStringList m_paths;
+        bool m_moveToTrash;
+        QStringList m_trashPaths;
+        QAtomicInt m_removed;
+        QAtomicInt m_canceled;
+
+        //shared by the workers
+        QMutex m_mutex;
+        QWaitCondition m_wakeUp;
+        QList<Directory*> m_queue;
+        QSet<Directory*> m_directories;
+        QAtomicInt m_idleWorkers; //also read unlocked as a hint
+        int m_workers;
+        bool m_done;
+        QStringList m_failedPaths;
+
+        QString trashPath(const QString &path);
+        Directory *nextDirectory(QList<Directory*> &stack);
+        void shareDirectories(QList<Directory*> &stack);
+        void removeDirectory(Directory *directory, QList<Directory*> &stack);
+        void finishDirectory(Directory *directory);
+        void addFailedPath(const QByteArray &path);
+        bool removeRecursive(const QString &path);
+};
+
+#endif
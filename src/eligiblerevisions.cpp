@@ -0,0 +1,320 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "config.h"
+#include "eligiblerevisions.h"
+#include "eligiblerevisions.moc"
+#include "login.h"
+#include "sslservertrust.h"
+#include "statustext.h"
+#include "svnclient.h"
+#include "qsvnactions/qsvnactionscheduler.h"
+#include "qsvnactions/qsvnclientlogaction.h"
+
+//SvnQt
+#include "svnqt/log_entry.hpp"
+#include "svnqt/wc.hpp"
+
+//Qt
+#include <QtGui>
+
+
+QHash<QString, EligibleRevisions::LogCache> EligibleRevisions::m_logCache;
+
+bool EligibleRevisions::doEligibleRevisions(QWidget *parent, const QString url, const QString wc,
+                                            svn::RevisionRanges &revisionRanges)
+{
+    EligibleRevisions eligibleRevisions(parent, url, wc);
+    if (eligibleRevisions.exec() != QDialog::Accepted)
+        return false;
+
+    //unselected revisions between the selected ones are left out
+    QList<svn_revnum_t> revisions;
+    foreach (QTreeWidgetItem *item, eligibleRevisions.treeWidgetRevisions->selectedItems())
+        revisions << item->data(0, Qt::UserRole).toLongLong();
+    if (revisions.isEmpty())
+        return false;
+
+    revisionRanges = SvnClient::revisionRanges(revisions);
+    return true;
+}
+
+EligibleRevisions::RevisionRanges EligibleRevisions::mergedRanges(const QString &mergeInfo, const QString &sourcePath)
+{
+    //one line per source: /path:1-5,7,9-12*
+    RevisionRanges ranges;
+    foreach (QString line, mergeInfo.split('\n', QString::SkipEmptyParts))
+    {
+        int colon = line.lastIndexOf(':');
+        if (colon < 0 || line.left(colon).trimmed() != sourcePath)
+            continue;
+
+        foreach (QString range, line.mid(colon + 1).split(',', QString::SkipEmptyParts))
+        {
+            range = range.trimmed();
+            if (range.endsWith('*')) //non-inheritable, merged into the target itself
+                range.chop(1);
+
+            QStringList bounds = range.split('-');
+            bool okFirst, okLast = true;
+            svn_revnum_t first = bounds.at(0).toLong(&okFirst);
+            svn_revnum_t last = bounds.count() > 1 ? bounds.at(1).toLong(&okLast) : first;
+            if (okFirst && okLast)
+                ranges << RevisionRange(first, last);
+        }
+    }
+    qSort(ranges);
+    return ranges;
+}
+
+EligibleRevisions::EligibleRevisions(QWidget *parent, const QString url, const QString wc)
+    : QDialog(parent), m_logAction(0), m_copyAction(0), m_logJob(-1), m_copyJob(-1),
+      m_logRead(false), m_copyRevision(-1)
+{
+    setupUi(this);
+    m_url = url;
+    m_wc = wc;
+    setWindowTitle(QString(tr("Eligible Revisions from %1")).arg(url));
+
+    connect(treeWidgetRevisions, SIGNAL(itemSelectionChanged()), this, SLOT(updateButtons()));
+    connect(treeWidgetRevisions, SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)), this, SLOT(accept()));
+
+    Config::instance()->restoreWidget(this);
+    Config::instance()->restoreHeaderView(this, treeWidgetRevisions->header());
+
+    readMergeInfo();
+
+    //the log is read once per source and working copy, later only the new revisions
+    const QString key = m_url + "\n" + m_wc;
+    m_logAction = new QSvnClientLogAction(0, m_url, m_logCache.contains(key) ? m_logCache.value(key).head + 1 : 0);
+    m_logJob = startLog(m_logAction, SLOT(onLogRead()));
+
+    //the oldest revision of the working copy tells where it was copied from
+    m_copyAction = new QSvnClientLogAction(0, svn::Wc(0).getUrl(m_wc), 0, true, 1);
+    m_copyJob = startLog(m_copyAction, SLOT(onCopyRead()));
+
+    fillRevisions();
+}
+
+EligibleRevisions::~EligibleRevisions()
+{
+    Config::instance()->saveWidget(this);
+    Config::instance()->saveHeaderView(this, treeWidgetRevisions->header());
+
+    stopLog(m_logAction, m_logJob);
+    stopLog(m_copyAction, m_copyJob);
+}
+
+QString EligibleRevisions::reposPath(const QString &url) const
+{
+    QString path = url;
+    if (!m_reposRoot.isEmpty() && path.startsWith(m_reposRoot))
+        path = QUrl::fromPercentEncoding(path.mid(m_reposRoot.length()).toUtf8());
+    while (path.endsWith('/'))
+        path.chop(1);
+    if (!path.startsWith('/'))
+        path.prepend('/');
+    return path;
+}
+
+void EligibleRevisions::readMergeInfo()
+{
+    //merged revisions come from the working copy, it may have changed since the last time
+    QString mergeInfo;
+    svn::PathPropertiesMapListPtr propList =
+            SvnClient::instance()->propList(m_wc, svn::Revision::WORKING, svn::Revision::WORKING);
+    if (propList && !propList->isEmpty())
+        mergeInfo = propList->at(0).second.value("svn:mergeinfo");
+
+    m_reposRoot = svn::Wc(0).getRepos(m_wc);
+    m_sourcePath = reposPath(m_url);
+    m_mergedRanges = mergedRanges(mergeInfo, m_sourcePath);
+}
+
+int EligibleRevisions::startLog(QSvnClientLogAction *action, const char *readSlot)
+{
+    connect(action, SIGNAL(finished(QString)), this, readSlot);
+    connect(action, SIGNAL(finished()), this, SLOT(onLogFinished()));
+    connect(action, SIGNAL(finished()), action, SLOT(deleteLater()));
+    connect(action, SIGNAL(notify(QString, QString)), this, SLOT(onNotify(QString, QString)));
+    connect(action, SIGNAL(doGetLogin(QString,QString,QString,bool)), this, SLOT(onGetLogin(QString,QString,QString,bool)));
+    connect(action, SIGNAL(doGetSslServerTrustPrompt()), this, SLOT(onGetSslServerTrustPrompt()));
+    return QSvnActionScheduler::instance()->enqueue(action, QSvnActionScheduler::Interactive,
+                                                    QUrl(action->url()).host(), QString(),
+                                                    QSvnActionScheduler::Shared);
+}
+
+void EligibleRevisions::stopLog(QSvnClientLogAction *action, int job)
+{
+    //a running log stops at the next cancel check and deletes itself
+    if (!action)
+        return;
+    disconnect(action, 0, this, 0);
+    if (QSvnActionScheduler::instance()->cancel(job))
+        delete action;
+    else
+        action->cancelAction();
+}
+
+void EligibleRevisions::fillRevisions()
+{
+    treeWidgetRevisions->clear();
+    if (m_logAction || m_copyAction)
+    {
+        labelSummary->setText(QString(tr("Reading the log of %1...")).arg(m_url));
+        updateButtons();
+        return;
+    }
+    if (!m_logRead)
+    {
+        labelSummary->setText(QString(tr("The log of %1 could not be read.")).arg(m_url));
+        updateButtons();
+        return;
+    }
+
+    const svn::LogEntriesMap &logEntries = m_logCache.value(m_url + "\n" + m_wc).logEntries;
+    bool showMerged = checkBoxShowMerged->isChecked();
+    int eligible = 0, merged = 0;
+    QList<QTreeWidgetItem*> items;
+    QDateTime dateTime;
+
+    //revisions and ranges are both sorted, so one pass finds the merged revisions
+    RevisionRanges::const_iterator range = m_mergedRanges.constBegin();
+    for (svn::LogEntriesMap::const_iterator it = logEntries.upperBound(m_copyRevision); it != logEntries.constEnd(); ++it)
+    {
+        svn_revnum_t revision = it.key();
+        while (range != m_mergedRanges.constEnd() && range->second < revision)
+            ++range;
+        bool isMerged = range != m_mergedRanges.constEnd() && range->first <= revision;
+        if (isMerged)
+            ++merged;
+        else
+            ++eligible;
+        if (isMerged && !showMerged)
+            continue;
+
+        QTreeWidgetItem *item = new QTreeWidgetItem();
+        item->setText(0, QString::number(revision));
+        item->setData(0, Qt::UserRole, qlonglong(revision));
+        item->setText(1, isMerged ? tr("merged") : tr("eligible"));
+        item->setText(2, it.value().author);
+        dateTime.setTime_t(it.value().date / (1000*1000));
+        item->setText(3, dateTime.toString("yyyy-MM-dd hh:mm:ss"));
+        item->setText(4, it.value().message.section('\n', 0, 0));
+        item->setToolTip(4, it.value().message);
+        if (isMerged)
+        {
+            for (int column = 0; column < treeWidgetRevisions->columnCount(); ++column)
+                item->setForeground(column, QBrush(Qt::gray));
+        }
+        items.prepend(item); //newest first
+    }
+
+    treeWidgetRevisions->addTopLevelItems(items);
+    QString summary = QString(tr("%1 eligible, %2 merged Revisions")).arg(eligible).arg(merged);
+    if (m_copyRevision >= 0)
+        summary += QString(tr(", Revisions up to %1 came with the copy of the working copy")).arg(m_copyRevision);
+    //only the own svn:mergeinfo and the direct copy of the working copy are followed
+    summary += "\n" + tr("Mergeinfo inherited from parent paths and older copies is not considered.");
+    labelSummary->setText(summary);
+    updateButtons();
+}
+
+void EligibleRevisions::on_checkBoxShowMerged_toggled(bool checked)
+{
+    fillRevisions();
+}
+
+void EligibleRevisions::updateButtons()
+{
+    buttonBox->button(QDialogButtonBox::Ok)->setEnabled(!treeWidgetRevisions->selectedItems().isEmpty());
+}
+
+void EligibleRevisions::onLogRead()
+{
+    if (!m_logAction)
+        return;
+
+    LogCache &cache = m_logCache[m_url + "\n" + m_wc];
+    cache.head = m_logAction->headRevision();
+    cache.logEntries.unite(m_logAction->logEntries());
+    m_logRead = true;
+}
+
+void EligibleRevisions::onCopyRead()
+{
+    if (!m_copyAction || m_copyAction->logEntries().isEmpty())
+        return;
+
+    //a copy of the source, or of one of its parents, brings the history of the source up to the copied revision
+    const QString targetPath = reposPath(m_copyAction->url());
+    foreach (svn::LogChangePathEntry changedPath, m_copyAction->logEntries().constBegin().value().changedPaths)
+    {
+        if (changedPath.copyFromPath.isEmpty())
+            continue;
+        if (targetPath != changedPath.path && !targetPath.startsWith(changedPath.path + "/"))
+            continue;
+        if (changedPath.copyFromPath + targetPath.mid(changedPath.path.length()) == m_sourcePath)
+            m_copyRevision = changedPath.copyFromRevision;
+    }
+}
+
+void EligibleRevisions::onLogFinished()
+{
+    QObject *action = sender();
+    if (action == m_logAction)
+    {
+        m_logAction = 0;
+        m_logJob = -1;
+    }
+    if (action == m_copyAction)
+    {
+        m_copyAction = 0;
+        m_copyJob = -1;
+    }
+    fillRevisions();
+}
+
+void EligibleRevisions::onNotify(QString action, QString path)
+{
+    StatusText::out(QString("%1 %2").arg(action).arg(path));
+}
+
+void EligibleRevisions::onGetLogin(QString realm, QString username, QString password, bool maySave)
+{
+    QSvnClientAction *action = qobject_cast<QSvnClientAction*>(sender());
+    if (!action)
+        return;
+
+    if (Login::doLogin(this, realm, username, password, maySave))
+        action->endGetLogin(username, password, maySave);
+    else
+        action->abortEmit();
+}
+
+void EligibleRevisions::onGetSslServerTrustPrompt()
+{
+    QSvnClientAction *action = qobject_cast<QSvnClientAction*>(sender());
+    if (!action)
+        return;
+
+    action->endGetSslServerTrustPrompt(SslServerTrust::getSslServerTrustAnswer(action->getSslServerTrustData()));
+}
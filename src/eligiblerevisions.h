@@ -0,0 +1,105 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef ELIGIBLEREVISIONS_H
+#define ELIGIBLEREVISIONS_H
+
+//QSvn
+#include "ui_eligiblerevisions.h"
+
+//SvnQt
+#include "svnqt/client.hpp"
+
+//Qt
+#include <QDialog>
+#include <QHash>
+#include <QList>
+#include <QPair>
+
+class QSvnClientLogAction;
+
+
+/**
+Lists the revisions of a merge source and marks the ones already merged
+into the working copy, following the svn:mergeinfo of the working copy.
+If the working copy was copied from the source, the revisions up to the
+copy are left out. The log is read in the background.
+*/
+class EligibleRevisions : public QDialog, public Ui::EligibleRevisions
+{
+        Q_OBJECT
+
+    public:
+        typedef QPair<svn_revnum_t, svn_revnum_t> RevisionRange; //first and last revision
+        typedef QList<RevisionRange> RevisionRanges;
+
+        /**
+         * Let the user select revisions of url to merge into wc.
+         * @param revisionRanges Ranges covering exactly the selected revisions.
+         * @return true, if revisions were selected.
+         */
+        static bool doEligibleRevisions(QWidget *parent, const QString url, const QString wc,
+                                        svn::RevisionRanges &revisionRanges);
+
+        /**
+         * Merged ranges of sourcePath in the value of a svn:mergeinfo property, sorted.
+         * @param sourcePath Path of the merge source relative to the repository root.
+         */
+        static RevisionRanges mergedRanges(const QString &mergeInfo, const QString &sourcePath);
+
+    private:
+        //log of a merge source, read up to head
+        struct LogCache
+        {
+            svn_revnum_t head;
+            svn::LogEntriesMap logEntries;
+        };
+        //by url and working copy
+        static QHash<QString, LogCache> m_logCache;
+
+        QString m_url, m_wc;
+        QString m_reposRoot, m_sourcePath;
+        RevisionRanges m_mergedRanges;
+        QSvnClientLogAction *m_logAction, *m_copyAction;
+        int m_logJob, m_copyJob;
+        bool m_logRead;
+        svn_revnum_t m_copyRevision; //last revision of the source the working copy was copied from, -1 if none
+
+        EligibleRevisions(QWidget *parent, const QString url, const QString wc);
+        ~EligibleRevisions();
+
+        QString reposPath(const QString &url) const;
+        void readMergeInfo();
+        int startLog(QSvnClientLogAction *action, const char *readSlot);
+        void stopLog(QSvnClientLogAction *action, int job);
+        void fillRevisions();
+
+    private slots:
+        void on_checkBoxShowMerged_toggled(bool checked);
+        void updateButtons();
+        void onLogRead();
+        void onCopyRead();
+        void onLogFinished();
+        void onNotify(QString action, QString path);
+        void onGetLogin(QString realm, QString username, QString password, bool maySave);
+        void onGetSslServerTrustPrompt();
+};
+
+#endif
@@ -40,9 +40,14 @@ FileListProxy::FileListProxy(QObject *parent)
 
 bool FileListProxy::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    svn::StatusPtr status = static_cast<StatusEntriesModel*>(sourceModel())->at(source_row);
-    if (QFileInfo(status->path()).isDir()) // don't show any directories in filelist
-        return false;
-    else
-        return true;
+    //don't show any directories in filelist, but keep missing or obstructed ones to be reverted
+    StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+    quint32 brokenMask = (1 << svn_wc_status_missing) | (1 << svn_wc_status_obstructed);
+    return !model->isDir(source_row) || (model->statusMask(source_row) & brokenMask);
+}
+
+bool FileListProxy::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    return static_cast<StatusEntriesModel*>(sourceModel())->lessThan(left.row(), right.row(),
+                                                                     left.column(), sortCaseSensitivity());
 }
@@ -33,6 +33,7 @@ class FileListProxy : public QSortFilterProxyModel
 
     protected:
         bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const;
+        bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
 };
 
 #endif
@@ -23,10 +23,15 @@
 #include "fileselector.h"
 #include "fileselector.moc"
 #include "fileselectorproxy.h"
+#include "login.h"
 #include "qsvn.h"
 #include "showlog.h"
+#include "sslservertrust.h"
 #include "statusentriesmodel.h"
+#include "statustext.h"
 #include "svnclient.h"
+#include "qsvnactions/qsvnactionscheduler.h"
+#include "qsvnactions/qsvnclientcommitaction.h"
 
 //SvnCpp
 #include "svnqt/status.hpp"
@@ -35,10 +40,14 @@
 #include <QtGui>
 
 
+//refresh rate of the commit progress in milliseconds
+#define REFRESH_INTERVAL 250
+
 FileSelector::FileSelector(QSvn *parent,
                            const SvnClient::SvnAction svnAction,
                            const QStringList pathList, const bool isFileList,
-                           const QString wc)
+                           const QString wc,
+                           const QSharedPointer<StatusEntriesModel> &sharedModel)
         : QDialog(0) //don't set parent here! FileSelector is always a top-level window
 {
     setupUi(this);
@@ -46,17 +55,35 @@ FileSelector::FileSelector(QSvn *parent,
     qsvn = parent;
     m_wc = wc;
     m_cfgStrLogMessages = QString("logHistory_%1").arg(SvnClient::instance()->getUUID(m_wc));
-    m_statusEntriesModel = new StatusEntriesModel(this);
+    m_sharedModel = !sharedModel.isNull();
+    if (m_sharedModel)
+        m_statusEntriesModel = sharedModel;
+    else
+        m_statusEntriesModel = QSharedPointer<StatusEntriesModel>(new StatusEntriesModel(0));
     m_fileSelectorProxy = new FileSelectorProxy(this, svnAction);
-    m_fileSelectorProxy->setSourceModel(m_statusEntriesModel);
-    if (isFileList)
+    m_fileSelectorProxy->setSourceModel(m_statusEntriesModel.data());
+    setupFileSelector(svnAction);
+    //directories are read in the background, the dialog is usable in the meantime
+    if (m_sharedModel)
+        m_fileSelectorProxy->setRootDirectory(pathList.at(0));
+    else if (isFileList)
         m_statusEntriesModel->readFileList(pathList);
     else
-        m_statusEntriesModel->readDirectory(pathList.at(0), svn::DepthInfinity, true);
-    setupFileSelector(svnAction);
+        m_statusEntriesModel->scanDirectories(pathList);
+    if (m_statusEntriesModel->isScanning())
+    {
+        buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+        buttonPartialList->setVisible(true);
+    }
     checkSelectAll->setCheckState(Qt::CheckState(Config::instance()->value("selectAll" + SvnClient::instance()->getSvnActionName(m_svnAction)).toInt()));
 
     m_inClose = false;
+
+    m_commitAction = 0;
+    m_commitJob = -1;
+    m_progressTimer = new QTimer(this);
+    m_progressTimer->setInterval(REFRESH_INTERVAL);
+    connect(m_progressTimer, SIGNAL(timeout()), this, SLOT(onUpdateProgress()));
 }
 
 FileSelector::~FileSelector()
@@ -83,7 +110,13 @@ void FileSelector::setupFileSelector(SvnClient::SvnAction svnAction)
 
 void FileSelector::setupDlg()
 {
-    setWindowTitle(tr("%1 [%2]").arg(SvnClient::instance()->getSvnActionName(m_svnAction)).arg(m_wc));
+    updateWindowTitle();
+
+    //ok is enabled, when the list is complete or the user takes the partial one
+    buttonPartialList = buttonBox->addButton(tr("Use &partial List"), QDialogButtonBox::ActionRole);
+    buttonPartialList->setVisible(false);
+    progressCommit->setVisible(false);
+    labelProgress->setVisible(false);
     switch (m_svnAction)
     {
         case SvnClient::SvnNone:
@@ -141,6 +174,23 @@ void FileSelector::setupMenus()
          (m_svnAction == SvnClient::SvnDelete) ||
          (m_svnAction == SvnClient::SvnRevert))
         contextMenu->addAction(actionShowLog);
+
+    //check many entries at once
+    actionCheckStatus = new QAction(tr("Check all with this Status"), this);
+    actionUncheckStatus = new QAction(tr("Uncheck all with this Status"), this);
+    actionCheckDirectory = new QAction(tr("Check all in this Directory"), this);
+    actionUncheckDirectory = new QAction(tr("Uncheck all in this Directory"), this);
+    connect(actionCheckStatus, SIGNAL(triggered()), this, SLOT(onCheckStatus()));
+    connect(actionUncheckStatus, SIGNAL(triggered()), this, SLOT(onUncheckStatus()));
+    connect(actionCheckDirectory, SIGNAL(triggered()), this, SLOT(onCheckDirectory()));
+    connect(actionUncheckDirectory, SIGNAL(triggered()), this, SLOT(onUncheckDirectory()));
+
+    if (!contextMenu->isEmpty())
+        contextMenu->addSeparator();
+    contextMenu->addAction(actionCheckStatus);
+    contextMenu->addAction(actionUncheckStatus);
+    contextMenu->addAction(actionCheckDirectory);
+    contextMenu->addAction(actionUncheckDirectory);
 }
 
 void FileSelector::setupConnections()
@@ -153,10 +203,16 @@ void FileSelector::setupConnections()
             SIGNAL(doubleClicked(const QModelIndex &)),
             this,
             SLOT(on_actionDiff_triggered()));
-    connect(m_statusEntriesModel, SIGNAL(beginUpdate()),
+    connect(m_statusEntriesModel.data(), SIGNAL(beginUpdate()),
         this, SLOT(onFsWatcherBeginUpdate()));
-    connect(m_statusEntriesModel, SIGNAL(endUpdate()),
+    connect(m_statusEntriesModel.data(), SIGNAL(endUpdate()),
         this, SLOT(onFsWatcherEndUpdate()));
+    connect(m_statusEntriesModel.data(), SIGNAL(scanProgress(int, int)),
+        this, SLOT(onScanProgress(int, int)));
+    connect(m_statusEntriesModel.data(), SIGNAL(scanFinished()),
+        this, SLOT(onScanFinished()));
+    connect(buttonPartialList, SIGNAL(clicked()),
+        this, SLOT(onUsePartialList()));
 }
 
 void FileSelector::showModeless()
@@ -169,7 +225,9 @@ void FileSelector::showModeless()
 
 void FileSelector::accept()
 {
-    m_inClose = true;
+    if (!buttonBox->button(QDialogButtonBox::Ok)->isEnabled() || m_commitAction)
+        return;
+
     if (m_svnAction == SvnClient::SvnCommit)
     {
         if ((editLogMessage->toPlainText().isEmpty()) &&
@@ -199,17 +257,27 @@ void FileSelector::accept()
 
     Config::instance()->saveHeaderView(this, treeViewFiles->header());
 
+    m_inClose = true;
+    //the checked entries must not change anymore
+    if (!m_sharedModel)
+        m_statusEntriesModel->cancelScan();
+
+    //a commit runs in the background, the dialog is closed when it is done
+    if (m_svnAction == SvnClient::SvnCommit)
+    {
+        startCommit();
+        return;
+    }
+
     //call svn actions
     setEnabled(false);
     qApp->processEvents();
+    SvnClient::instance()->takeTouchedPaths();
     switch (m_svnAction)
     {
         case SvnClient::SvnAdd:
             SvnClient::instance()->add(m_fileSelectorProxy->checkedFileList(), svn::DepthEmpty);
             break;
-        case SvnClient::SvnCommit:
-            SvnClient::instance()->commit(m_fileSelectorProxy->checkedFileList(), editLogMessage->toPlainText());
-            break;
         case SvnClient::SvnDelete:
             SvnClient::instance()->remove(m_fileSelectorProxy->checkedFileList());
             break;
@@ -223,22 +291,197 @@ void FileSelector::accept()
             break;
     }
 
+    //removing from disk sends no notifications
+    QStringList touchedPaths = SvnClient::instance()->takeTouchedPaths();
+    if (m_svnAction == SvnClient::RemoveFromDisk)
+        touchedPaths << m_fileSelectorProxy->checkedFileList();
+    invalidatePaths(touchedPaths);
+    QDialog::accept();
+}
+
+void FileSelector::invalidatePaths(const QStringList &paths)
+{
     if (qsvn)
+        qsvn->invalidatePaths(paths);
+}
+
+void FileSelector::startCommit()
+{
+    StatusEntriesModel *model = m_statusEntriesModel.data();
+    m_commitPaths.clear();
+    m_commitSizes.clear();
+    m_commitBytes = 0;
+    m_transmittedBytes = 0;
+    m_transmittedFiles = 0;
+    m_sentBytes = 0;
+    m_commitSucceeded = false;
+    foreach (int row, m_fileSelectorProxy->checkedRows())
     {
-        foreach(QString path, m_fileSelectorProxy->checkedFileList())
+        svn::StatusPtr status = model->at(row);
+        m_commitPaths << status->path();
+
+        //only files with a new content are transmitted
+        if (!model->isDir(row) &&
+            ((status->textStatus() == svn_wc_status_modified) ||
+             (status->textStatus() == svn_wc_status_added) ||
+             (status->textStatus() == svn_wc_status_replaced)))
         {
-            if (QFileInfo(path).isDir())
-            {
-                qsvn->updateWc(path);
-            }
+            m_commitSizes.insert(pathKey(status->path()), model->fileSize(row));
+            m_commitBytes += model->fileSize(row);
         }
     }
-    QDialog::accept();
+
+    groupBoxFiles->setEnabled(false);
+    groupBoxLogMessage->setEnabled(false);
+    buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+    buttonPartialList->setVisible(false);
+    progressCommit->setRange(0, m_commitBytes > 0 ? 1000 : qMax(m_commitSizes.count(), 1));
+    progressCommit->setValue(0);
+    progressCommit->setVisible(true);
+    labelProgress->setVisible(true);
+    StatusText::out(tr("\nStart Commit"));
+
+    m_commitAction = new QSvnClientCommitAction(m_commitPaths, editLogMessage->toPlainText());
+    connect(m_commitAction, SIGNAL(notify(QString, QString)), this, SLOT(onCommitNotify(QString, QString)));
+    connect(m_commitAction, SIGNAL(fileTransmitted(QString)), this, SLOT(onFileTransmitted(QString)));
+    connect(m_commitAction, SIGNAL(finished(QString)), this, SLOT(onCommitSucceeded(QString)));
+    connect(m_commitAction, SIGNAL(finished()), this, SLOT(onCommitFinished()));
+    connect(m_commitAction, SIGNAL(finished()), m_commitAction, SLOT(deleteLater()));
+    connect(m_commitAction, SIGNAL(doGetLogin(QString,QString,QString,bool)), this, SLOT(onGetLogin(QString,QString,QString,bool)));
+    connect(m_commitAction, SIGNAL(doGetSslServerTrustPrompt()), this, SLOT(onGetSslServerTrustPrompt()));
+
+    m_commitTime.start();
+    m_progressTimer->start();
+    m_commitJob = QSvnActionScheduler::instance()->enqueue(m_commitAction, QSvnActionScheduler::Interactive,
+                                                           SvnClient::instance()->repositoryHost(m_wc), m_wc);
+}
+
+QString FileSelector::pathKey(const QString &path)
+{
+    return QDir::toNativeSeparators(QDir::cleanPath(path));
+}
+
+void FileSelector::onCommitNotify(QString action, QString path)
+{
+    StatusText::out(QString("%1 %2").arg(action).arg(path));
+}
+
+void FileSelector::onFileTransmitted(QString path)
+{
+    ++m_transmittedFiles;
+    m_transmittedBytes += m_commitSizes.value(pathKey(path), 0);
+}
+
+void FileSelector::onCommitSucceeded(QString path)
+{
+    m_commitSucceeded = true;
+}
+
+void FileSelector::onCommitFinished()
+{
+    QStringList touchedPaths;
+    if (m_commitAction)
+    {
+        m_sentBytes = m_commitAction->transferredBytes();
+        touchedPaths = m_commitAction->touchedPaths();
+    }
+    m_commitAction = 0;
+    m_commitJob = -1;
+    m_progressTimer->stop();
+    onUpdateProgress();
+
+    if (m_commitSucceeded)
+    {
+        SvnClient::instance()->completedMessage(m_commitPaths.isEmpty() ? QString() : m_commitPaths.at(0));
+        invalidatePaths(touchedPaths);
+        QDialog::accept();
+    }
+    else
+    {
+        //failed or canceled, the user may try again
+        m_inClose = false;
+        groupBoxFiles->setEnabled(true);
+        groupBoxLogMessage->setEnabled(true);
+        buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+    }
+}
+
+void FileSelector::onUpdateProgress()
+{
+    if (m_commitAction)
+        m_sentBytes = m_commitAction->transferredBytes();
+
+    double seconds = qMax(m_commitTime.elapsed(), 1) / 1000.0;
+    int totalFiles = qMax(m_commitSizes.count(), m_transmittedFiles);
+    if (m_commitBytes > 0)
+        progressCommit->setValue(int(qMin(m_transmittedBytes, m_commitBytes) * 1000 / m_commitBytes));
+    else
+        progressCommit->setValue(qMin(m_transmittedFiles, progressCommit->maximum()));
+
+    //the remaining time follows the rate of the files sent so far
+    QString remaining = tr("unknown");
+    if (m_transmittedBytes > 0 && m_commitBytes > 0)
+    {
+        int secondsLeft = int(seconds * (m_commitBytes - qMin(m_transmittedBytes, m_commitBytes)) / m_transmittedBytes);
+        remaining = QTime(0, 0).addSecs(secondsLeft).toString("hh:mm:ss");
+    }
+    else if (m_transmittedFiles > 0 && m_commitBytes == 0)
+    {
+        int secondsLeft = int(seconds * (totalFiles - m_transmittedFiles) / m_transmittedFiles);
+        remaining = QTime(0, 0).addSecs(secondsLeft).toString("hh:mm:ss");
+    }
+
+    double megaBytes = m_transmittedBytes / (1024.0 * 1024.0);
+    labelProgress->setText(tr("%1 of %2 files, %3 of %4 MB (%5 MB/s), %6 MB sent, %7 left")
+            .arg(m_transmittedFiles)
+            .arg(totalFiles)
+            .arg(megaBytes, 0, 'f', 2)
+            .arg(m_commitBytes / (1024.0 * 1024.0), 0, 'f', 2)
+            .arg(megaBytes / seconds, 0, 'f', 2)
+            .arg(m_sentBytes / (1024.0 * 1024.0), 0, 'f', 2)
+            .arg(remaining));
+}
+
+void FileSelector::onGetLogin(QString realm, QString username, QString password, bool maySave)
+{
+    QSvnClientCommitAction *action = qobject_cast<QSvnClientCommitAction*>(sender());
+    if (!action)
+        return;
+
+    if (Login::doLogin(this, realm, username, password, maySave))
+        action->endGetLogin(username, password, maySave);
+    else
+        action->abortEmit();
+}
+
+void FileSelector::onGetSslServerTrustPrompt()
+{
+    QSvnClientCommitAction *action = qobject_cast<QSvnClientCommitAction*>(sender());
+    if (!action)
+        return;
+
+    action->endGetSslServerTrustPrompt(SslServerTrust::getSslServerTrustAnswer(action->getSslServerTrustData()));
 }
 
 void FileSelector::reject()
 {
+    //cancel a running commit first, the dialog stays open until it has stopped
+    if (m_commitAction)
+    {
+        if (QSvnActionScheduler::instance()->cancel(m_commitJob))
+        {
+            delete m_commitAction;
+            m_commitAction = 0;
+            onCommitFinished();
+        }
+        else
+            m_commitAction->cancelAction();
+        return;
+    }
+
     m_inClose = true;
+    if (!m_sharedModel)
+        m_statusEntriesModel->cancelScan();
     QDialog::reject();
 }
 
@@ -266,6 +509,8 @@ void FileSelector::keyPressEvent(QKeyEvent *event)
 {
     if (event->key() == Qt::Key_F5)
     {
+        if (m_statusEntriesModel->isScanning() || m_commitAction)
+            return;
         m_statusEntriesModel->refresh();
     } else
     {
@@ -316,6 +561,52 @@ void FileSelector::on_actionShowLog_triggered()
     ShowLog::doShowLog(0, fullFileName, svn::Revision::HEAD, svn::Revision::START);
 }
 
+svn::StatusPtr FileSelector::currentStatus()
+{
+    QModelIndex index = treeViewFiles->selectionModel()->currentIndex();
+    return m_statusEntriesModel->at(m_fileSelectorProxy->mapToSource(index).row());
+}
+
+void FileSelector::checkCurrentStatus(bool checked)
+{
+    if (!treeViewFiles->selectionModel()->currentIndex().isValid())
+        return;
+
+    svn::StatusPtr status = currentStatus();
+    if (status->textStatus() != svn_wc_status_normal)
+        m_fileSelectorProxy->checkByStatus(status->textStatus(), checked);
+    else
+        m_fileSelectorProxy->checkByStatus(status->propStatus(), checked);
+}
+
+void FileSelector::checkCurrentDirectory(bool checked)
+{
+    if (!treeViewFiles->selectionModel()->currentIndex().isValid())
+        return;
+
+    m_fileSelectorProxy->checkUnderDirectory(QFileInfo(currentStatus()->path()).path(), checked);
+}
+
+void FileSelector::onCheckStatus()
+{
+    checkCurrentStatus(true);
+}
+
+void FileSelector::onUncheckStatus()
+{
+    checkCurrentStatus(false);
+}
+
+void FileSelector::onCheckDirectory()
+{
+    checkCurrentDirectory(true);
+}
+
+void FileSelector::onUncheckDirectory()
+{
+    checkCurrentDirectory(false);
+}
+
 void FileSelector::on_actionDiff_triggered()
 {
     if (!actionDiff->isEnabled())
@@ -343,10 +634,36 @@ void FileSelector::onFsWatcherBeginUpdate()
 
 void FileSelector::onFsWatcherEndUpdate()
 {
-    setWindowTitle(tr("%1 [%2]").arg(SvnClient::instance()->getSvnActionName(m_svnAction)).arg(m_wc));
+    updateWindowTitle();
     setEnabled(true);
 }
 
+void FileSelector::updateWindowTitle()
+{
+    setWindowTitle(tr("%1 [%2]").arg(SvnClient::instance()->getSvnActionName(m_svnAction)).arg(m_wc));
+}
+
+void FileSelector::onScanProgress(int done, int total)
+{
+    if (m_statusEntriesModel->isScanning())
+        setWindowTitle(tr("%1 - reading status %2/%3 [%4]")
+                .arg(SvnClient::instance()->getSvnActionName(m_svnAction))
+                .arg(done).arg(total).arg(m_wc));
+}
+
+void FileSelector::onScanFinished()
+{
+    updateWindowTitle();
+    buttonPartialList->setVisible(false);
+    buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+}
+
+void FileSelector::onUsePartialList()
+{
+    buttonPartialList->setVisible(false);
+    buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+}
+
 //static functions
 void FileSelector::doSvnAction(QSvn *parent,
                                const SvnClient::SvnAction svnAction,
@@ -361,13 +678,23 @@ void FileSelector::doSvnAction(QSvn *parent,
     }
     else
     {
-        QStringList singlePathList;
-        foreach (QString path, pathList)
+        QStringList directories = StatusEntriesModel::collapsePaths(pathList);
+        if ((directories.count() == 1) ||
+            Config::instance()->value(KEY_COMBINEDFILESELECTOR).toBool())
         {
-            singlePathList.clear();
-            singlePathList << path;
-            FileSelector *fs = new FileSelector(parent, svnAction, singlePathList, isFileList, wc);
+            FileSelector *fs = new FileSelector(parent, svnAction, directories, isFileList, wc);
             fs->showModeless();
         }
+        else
+        {
+            //one dialog per directory, but only one status scan for all of them
+            QSharedPointer<StatusEntriesModel> model(new StatusEntriesModel(0));
+            model->scanDirectories(directories);
+            foreach (QString directory, directories)
+            {
+                FileSelector *fs = new FileSelector(parent, svnAction, QStringList(directory), isFileList, wc, model);
+                fs->showModeless();
+            }
+        }
     }
 }
@@ -32,8 +32,13 @@ class StatusEntriesModel;
 
 class QSvn;
 
+class QSvnClientCommitAction;
+
 //Qt
 #include <QDialog>
+#include <QSharedPointer>
+#include <QTime>
+#include <QTimer>
 
 
 class FileSelector : public QDialog, public Ui::FileSelector
@@ -57,7 +62,8 @@ class FileSelector : public QDialog, public Ui::FileSelector
                      const SvnClient::SvnAction svnAction,
                      const QStringList pathList,
                      const bool isFileList,
-                     const QString wc);
+                     const QString wc,
+                     const QSharedPointer<StatusEntriesModel> &sharedModel = QSharedPointer<StatusEntriesModel>());
         ~FileSelector();
 
         QSvn *qsvn;
@@ -69,15 +75,41 @@ class FileSelector : public QDialog, public Ui::FileSelector
 
         QItemSelectionModel *m_selectionModel;
         QMenu *contextMenu;
-        StatusEntriesModel *m_statusEntriesModel;
+        QAction *actionCheckStatus;
+        QAction *actionUncheckStatus;
+        QAction *actionCheckDirectory;
+        QAction *actionUncheckDirectory;
+        QSharedPointer<StatusEntriesModel> m_statusEntriesModel;
+        bool m_sharedModel; //other dialogs show other directories of the same model
         FileSelectorProxy *m_fileSelectorProxy;
+        QPushButton *buttonPartialList;
         bool m_inClose;
 
+        //background commit
+        QSvnClientCommitAction *m_commitAction;
+        int m_commitJob;
+        bool m_commitSucceeded;
+        QStringList m_commitPaths;
+        QHash<QString, qint64> m_commitSizes; //files with a new content and their size
+        qint64 m_commitBytes;
+        qint64 m_transmittedBytes;
+        int m_transmittedFiles;
+        qlonglong m_sentBytes;
+        QTime m_commitTime;
+        QTimer *m_progressTimer;
+
         void showModeless();
         void setupFileSelector(SvnClient::SvnAction svnAction);
         void setupDlg();
         void setupMenus();
         void setupConnections();
+        void updateWindowTitle();
+        void startCommit();
+        void invalidatePaths(const QStringList &paths);
+        static QString pathKey(const QString &path);
+        svn::StatusPtr currentStatus();
+        void checkCurrentStatus(bool checked);
+        void checkCurrentDirectory(bool checked);
 
     private slots:
         void accept();
@@ -91,9 +123,24 @@ class FileSelector : public QDialog, public Ui::FileSelector
         void on_actionRevert_triggered();
         void on_actionResolved_triggered();
         void on_actionShowLog_triggered();
+        void onCheckStatus();
+        void onUncheckStatus();
+        void onCheckDirectory();
+        void onUncheckDirectory();
 
         void onFsWatcherBeginUpdate();
         void onFsWatcherEndUpdate();
+        void onScanProgress(int done, int total);
+        void onScanFinished();
+        void onUsePartialList();
+
+        void onCommitNotify(QString action, QString path);
+        void onFileTransmitted(QString path);
+        void onCommitSucceeded(QString path);
+        void onCommitFinished();
+        void onUpdateProgress();
+        void onGetLogin(QString realm, QString username, QString password, bool maySave);
+        void onGetSslServerTrustPrompt();
 };
 
 #endif
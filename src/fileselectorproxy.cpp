@@ -28,6 +28,7 @@
 #include "svnqt/status.hpp"
 
 //Qt
+#include <QDir>
 #include <QSortFilterProxyModel>
 
 
@@ -39,6 +40,7 @@ FileSelectorProxy::FileSelectorProxy(QObject *parent,
 	setSortCaseSensitivity(Qt::CaseInsensitive);
 	#endif
     m_svnAction = svnAction;
+    m_checkNewRows = false;
     switch (m_svnAction)
     {
         case SvnClient::SvnAdd:
@@ -75,12 +77,112 @@ FileSelectorProxy::FileSelectorProxy(QObject *parent,
         default:
             break;
     }
+
+    m_visibleMask = 0;
+    foreach (svn_wc_status_kind kind, m_visibleStats)
+        m_visibleMask |= (1 << kind);
+}
+
+void FileSelectorProxy::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+    m_checkedRows = QBitArray(sourceModel->rowCount(), m_checkNewRows);
+    //check states are stored by source row and have to follow the source model
+    connect(sourceModel, SIGNAL(rowsInserted(const QModelIndex &, int, int)),
+            this, SLOT(onSourceRowsInserted(const QModelIndex &, int, int)));
+    connect(sourceModel, SIGNAL(rowsRemoved(const QModelIndex &, int, int)),
+            this, SLOT(onSourceRowsRemoved(const QModelIndex &, int, int)));
+    connect(sourceModel, SIGNAL(modelReset()), this, SLOT(onSourceModelReset()));
+    connect(sourceModel, SIGNAL(scanStarted()), this, SLOT(onSourceScanStarted()));
+    connect(sourceModel, SIGNAL(scanFinished()), this, SLOT(onSourceScanFinished()));
+}
+
+void FileSelectorProxy::setRootDirectory(const QString &directory)
+{
+    if (directory.isEmpty())
+        m_rootDirectory = QString();
+    else
+        m_rootDirectory = QDir::cleanPath(QDir::fromNativeSeparators(directory)) + "/";
+    invalidateFilter();
+}
+
+void FileSelectorProxy::onSourceRowsInserted(const QModelIndex &parent, int start, int end)
+{
+    int count = end - start + 1;
+    QBitArray rows(m_checkedRows.size() + count, m_checkNewRows);
+    for (int row = 0; row < m_checkedRows.size(); ++row)
+        rows.setBit(row < start ? row : row + count, m_checkedRows.testBit(row));
+
+    //rows read again by a scan, e.g. a refresh, keep their check state
+    if (!m_scanChecks.isEmpty())
+    {
+        StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+        for (int row = start; row <= end; ++row)
+            rows.setBit(row, m_scanChecks.value(model->at(row)->path(), m_checkNewRows));
+    }
+    m_checkedRows = rows;
+
+    if (m_checkNewRows)
+        emitCheckStateChanged();
+}
+
+void FileSelectorProxy::onSourceRowsRemoved(const QModelIndex &parent, int start, int end)
+{
+    int count = end - start + 1;
+    QBitArray rows(qMax(m_checkedRows.size() - count, 0));
+    for (int row = 0; row < rows.size(); ++row)
+        rows.setBit(row, m_checkedRows.testBit(row < start ? row : row + count));
+    m_checkedRows = rows;
+}
+
+void FileSelectorProxy::onSourceModelReset()
+{
+    StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+    m_checkedRows = QBitArray(model->rowCount(), m_checkNewRows);
+    for (int row = 0; row < model->rowCount() && !m_scanChecks.isEmpty(); ++row)
+        m_checkedRows.setBit(row, m_scanChecks.value(model->at(row)->path(), m_checkNewRows));
+
+    //only the rows of a running scan are still to come
+    if (!model->isScanning())
+        m_scanChecks.clear();
+}
+
+void FileSelectorProxy::onSourceScanStarted()
+{
+    StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+    m_scanChecks.clear();
+    for (int row = 0; row < m_checkedRows.size() && row < model->rowCount(); ++row)
+    {
+        if (m_checkedRows.testBit(row) != m_checkNewRows)
+            m_scanChecks.insert(model->at(row)->path(), m_checkedRows.testBit(row));
+    }
+}
+
+void FileSelectorProxy::onSourceScanFinished()
+{
+    m_scanChecks.clear();
 }
 
 bool FileSelectorProxy::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
 {
-    svn::StatusPtr status = static_cast<StatusEntriesModel*>(sourceModel())->at(source_row);
-    return m_visibleStats.contains(status->textStatus()) || m_visibleStats.contains(status->propStatus());
+    StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+    if (!(model->statusMask(source_row) & m_visibleMask))
+        return false;
+    if (m_rootDirectory.isEmpty())
+        return true;
+
+#if defined Q_WS_WIN32
+    Qt::CaseSensitivity cs = Qt::CaseInsensitive;
+#else
+    Qt::CaseSensitivity cs = Qt::CaseSensitive;
+#endif
+    return model->filterPath(source_row).startsWith(m_rootDirectory, cs);
+}
+
+bool FileSelectorProxy::lessThan(const QModelIndex &left, const QModelIndex &right) const
+{
+    return static_cast<StatusEntriesModel*>(sourceModel())->lessThan(left.row(), right.row(),
+                                                                     left.column(), sortCaseSensitivity());
 }
 
 QVariant FileSelectorProxy::data(const QModelIndex &index, int role) const
@@ -90,7 +192,8 @@ QVariant FileSelectorProxy::data(const QModelIndex &index, int role) const
 
     if ((role == Qt::CheckStateRole) && (index.column() == 0))
     {
-        if (checkedRows.contains(mapToSource(index).row()))
+        int row = mapToSource(index).row();
+        if (row < m_checkedRows.size() && m_checkedRows.testBit(row))
             return Qt::Checked;
         else
             return Qt::Unchecked;
@@ -108,10 +211,10 @@ bool FileSelectorProxy::setData(const QModelIndex &index, const QVariant &value,
 
     if (role == Qt::CheckStateRole)
     {
-        if (value == Qt::Checked)
-            checkedRows.insert(mapToSource(index).row());
-        else
-            checkedRows.remove(mapToSource(index).row());
+        int row = mapToSource(index).row();
+        if (row >= m_checkedRows.size())
+            return false;
+        m_checkedRows.setBit(row, value == Qt::Checked);
         emit dataChanged(index, index);
         return true;
     }
@@ -129,18 +232,60 @@ Qt::ItemFlags FileSelectorProxy::flags(const QModelIndex &index) const
 QStringList FileSelectorProxy::checkedFileList()
 {
     QStringList fileList;
-    QModelIndex index;
+    foreach (int row, checkedRows())
+        fileList << static_cast<StatusEntriesModel*>(sourceModel())->at(row)->path();
+    return fileList;
+}
 
-    foreach (int row, checkedRows)
+QList<int> FileSelectorProxy::checkedRows()
+{
+    QList<int> rows;
+    for (int row = 0; row < m_checkedRows.size(); ++row)
     {
-        fileList << static_cast<StatusEntriesModel*>(sourceModel())->at(row)->path();
+        //hidden rows may be checked too, but are not part of this list
+        if (m_checkedRows.testBit(row) && filterAcceptsRow(row, QModelIndex()))
+            rows << row;
     }
-
-    return fileList;
+    return rows;
 }
 
 void FileSelectorProxy::setSelectAllState(int state)
 {
+    m_checkNewRows = (state == Qt::Checked);
     for (int i = 0; i < rowCount(); ++i)
-        setData(index(i, 0), state, Qt::CheckStateRole);
+        m_checkedRows.setBit(mapToSource(index(i, 0)).row(), m_checkNewRows);
+    emitCheckStateChanged();
+}
+
+void FileSelectorProxy::checkByStatus(svn_wc_status_kind status, bool checked)
+{
+    StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+    quint32 mask = 1 << status;
+    for (int i = 0; i < rowCount(); ++i)
+    {
+        int row = mapToSource(index(i, 0)).row();
+        if (model->statusMask(row) & mask)
+            m_checkedRows.setBit(row, checked);
+    }
+    emitCheckStateChanged();
+}
+
+void FileSelectorProxy::checkUnderDirectory(const QString &directory, bool checked)
+{
+    StatusEntriesModel *model = static_cast<StatusEntriesModel*>(sourceModel());
+    QString prefix = QDir::cleanPath(QDir::fromNativeSeparators(directory)) + "/";
+    for (int i = 0; i < rowCount(); ++i)
+    {
+        int row = mapToSource(index(i, 0)).row();
+        if (model->filterPath(row).startsWith(prefix))
+            m_checkedRows.setBit(row, checked);
+    }
+    emitCheckStateChanged();
+}
+
+void FileSelectorProxy::emitCheckStateChanged()
+{
+    //one signal for the whole check column
+    if (rowCount() > 0)
+        emit dataChanged(index(0, 0), index(rowCount() - 1, 0));
 }
@@ -25,6 +25,8 @@
 #include "svnclient.h"
 
 //Qt
+#include <QBitArray>
+#include <QHash>
 #include <QSet>
 #include <QSortFilterProxyModel>
 
@@ -36,20 +38,50 @@ class FileSelectorProxy : public QSortFilterProxyModel
     public:
         FileSelectorProxy(QObject *parent, SvnClient::SvnAction svnAction);
 
+        void setSourceModel(QAbstractItemModel *sourceModel);
+        /**
+         * Show only entries below a directory, when the source model
+         * holds the status of several directories.
+         */
+        void setRootDirectory(const QString &directory);
+
         QVariant data(const QModelIndex &index, int role) const;
         bool setData(const QModelIndex &index, const QVariant &value, int role);
         Qt::ItemFlags flags(const QModelIndex &index) const;
 
         QStringList checkedFileList(); //return a list with full path from checked entries
-        void setSelectAllState(int state);
+        QList<int> checkedRows(); //source rows of the checked entries
+        void setSelectAllState(int state); //also used for rows, that are added later
+        /**
+         * Check or uncheck all visible entries with a text or property status.
+         */
+        void checkByStatus(svn_wc_status_kind status, bool checked);
+        /**
+         * Check or uncheck all visible entries below a directory.
+         */
+        void checkUnderDirectory(const QString &directory, bool checked);
 
     protected:
         bool filterAcceptsRow(int source_row, const QModelIndex &source_parent) const;
+        bool lessThan(const QModelIndex &left, const QModelIndex &right) const;
+
+    private slots:
+        void onSourceRowsInserted(const QModelIndex &parent, int start, int end);
+        void onSourceRowsRemoved(const QModelIndex &parent, int start, int end);
+        void onSourceModelReset();
+        void onSourceScanStarted();
+        void onSourceScanFinished();
 
     private:
-        QSet<int> checkedRows;
+        QBitArray m_checkedRows; //by source row
+        QHash<QString, bool> m_scanChecks; //check states by path from before a scan, for the rows it reads again
+        bool m_checkNewRows;
         SvnClient::SvnAction m_svnAction;
         QSet<svn_wc_status_kind> m_visibleStats;
+        quint32 m_visibleMask; //m_visibleStats as bits (1 << kind)
+        QString m_rootDirectory; //with trailing '/', empty for all entries
+
+        void emitCheckStateChanged();
 };
 
 #endif
@@ -19,6 +19,7 @@
  *******************************************************************************/
 
 //QSvn
+#include "diskremover.h"
 #include "helper.h"
 
 //Qt
@@ -27,21 +28,5 @@
 
 bool Helper::removeFromDisk(QString aPath)
 {
-    bool result = true;
-    QDir dir = QDir(aPath);
-    dir.setFilter(QDir::NoDotAndDotDot | QDir::Files | QDir::Hidden | QDir::Dirs);
-    foreach(QFileInfo fileInfo, dir.entryInfoList())
-    {
-        if(fileInfo.isFile())
-		{
-            QFile::setPermissions(fileInfo.filePath(), QFile::WriteOwner | QFile::ReadOwner);
-			result &= QFile::remove(fileInfo.filePath());
-		}
-		else if(fileInfo.isDir())
-        {
-            result &= Helper::removeFromDisk(fileInfo.filePath());
-        }
-    }
-    result &= dir.rmdir(aPath);
-    return result;
+    return DiskRemover::removeFromDisk(aPath);
 }
@@ -217,12 +217,48 @@ void Listener::contextNotify(const svn_wc_notify_t *action)
     if (!action)
         return;
 
+    if (action->path && isWcChange(action->action))
+        m_touchedPaths.insert(QDir::toNativeSeparators(QDir::cleanPath(action->path)));
+
     contextNotify(action->path, action->action, action->kind, action->mime_type,
                   action->content_state, action->prop_state, action->revision);
 
     qApp->processEvents();
 }
 
+QStringList Listener::takeTouchedPaths()
+{
+    QStringList paths = m_touchedPaths.toList();
+    m_touchedPaths.clear();
+    return paths;
+}
+
+bool Listener::isWcChange(svn_wc_notify_action_t action)
+{
+    switch (action)
+    {
+        case svn_wc_notify_add:
+        case svn_wc_notify_copy:
+        case svn_wc_notify_delete:
+        case svn_wc_notify_restore:
+        case svn_wc_notify_revert:
+        case svn_wc_notify_resolved:
+        case svn_wc_notify_update_delete:
+        case svn_wc_notify_update_add:
+        case svn_wc_notify_update_update:
+        case svn_wc_notify_update_replace:
+        case svn_wc_notify_commit_modified:
+        case svn_wc_notify_commit_added:
+        case svn_wc_notify_commit_deleted:
+        case svn_wc_notify_commit_replaced:
+        case svn_wc_notify_locked:
+        case svn_wc_notify_unlocked:
+            return true;
+        default:
+            return false;
+    }
+}
+
 bool Listener::contextCancel()
 {
     if (m_cancel)
@@ -26,6 +26,8 @@
 
 //Qt
 #include <QObject>
+#include <QSet>
+#include <QStringList>
 
 
 class Listener : public QObject, public svn::ContextListener
@@ -76,9 +78,20 @@ class Listener : public QObject, public svn::ContextListener
 
         void setCancel(bool cancel);
         void setVerbose(bool verbose);
+        /**
+         * Paths changed in the working copy by notifications since the last call.
+         */
+        QStringList takeTouchedPaths();
+
+        /**
+         * True for notifications about a changed path in the working copy,
+         * e.g. added, deleted, updated, committed or reverted ones.
+         */
+        static bool isWcChange(svn_wc_notify_action_t action);
 
     private:
         bool m_cancel, m_verbose;
+        QSet<QString> m_touchedPaths;
 };
 
 #endif
@@ -20,19 +20,33 @@
 
 //QSvn
 #include "config.h"
+#include "eligiblerevisions.h"
+#include "login.h"
 #include "merge.h"
 #include "merge.moc"
+#include "mergeresultmodel.h"
+#include "mergeresultproxy.h"
+#include "sslservertrust.h"
 #include "statustext.h"
 #include "svnclient.h"
+#include "qsvnactions/qsvnactionscheduler.h"
 
 //SvnCpp
 #include "svnqt/revision.hpp"
+#include "svnqt/status.hpp"
 #include "svnqt/wc.hpp"
 
 //Qt
 #include <QtGui>
 
 
+//refresh rate of the result tree in milliseconds
+#define REFRESH_INTERVAL 250
+//number of entries kept for all cached dry runs together
+#define RESULT_CACHE_ENTRIES 200000
+
+QCache<QString, QSvnClientMergeAction::Entries> Merge::m_resultCache(RESULT_CACHE_ENTRIES);
+
 void Merge::doMerge(const QString fromURL, const svn::Revision fromRevision,
                     const QString toURL, const svn::Revision toRevision,
                     const QString wc)
@@ -47,11 +61,48 @@ void Merge::doMerge(const QString fromURL, const svn::Revision fromRevision,
     merge->activateWindow();
     merge->groupBoxFrom->setEnabled(false);
     merge->groupBoxTo->setEnabled(false);
+    merge->buttonEligibleRevisions->setEnabled(false);
 
     const QString _uuid = SvnClient::instance()->getUUID(wc);
     merge->editWcPath->setText(Config::instance()->value(QString(KEY_LASTMERGEWC).arg(_uuid)).toString());
 }
 
+void Merge::doMerge(const QString url, const svn::RevisionRanges &revisionRanges,
+                    const QString wc)
+{
+    Merge *merge = new Merge();
+    merge->m_revisionRanges = revisionRanges;
+    merge->editFromUrl->setText(url);
+    merge->editFromRevision->setText(revisionRangesText(revisionRanges));
+    merge->labelFromRevision->setText(tr("Revisions"));
+    merge->groupBoxTo->setVisible(false);
+    merge->show();
+    merge->raise();
+    merge->activateWindow();
+    merge->groupBoxFrom->setEnabled(false);
+    merge->groupBoxTo->setEnabled(false);
+    merge->buttonEligibleRevisions->setEnabled(false);
+
+    const QString _uuid = SvnClient::instance()->getUUID(wc);
+    merge->editWcPath->setText(Config::instance()->value(QString(KEY_LASTMERGEWC).arg(_uuid)).toString());
+}
+
+QString Merge::revisionRangesText(const svn::RevisionRanges &revisionRanges)
+{
+    //the range N-1:M is shown as N-M
+    QStringList texts;
+    foreach (svn::RevisionRange range, revisionRanges)
+    {
+        svn_revnum_t first = range.first.revnum() + 1;
+        svn_revnum_t last = range.second.revnum();
+        if (first == last)
+            texts << QString::number(last);
+        else
+            texts << QString("%1-%2").arg(first).arg(last);
+    }
+    return texts.join(", ");
+}
+
 void Merge::doMerge(const QString wc)
 {
     Merge *merge = new Merge();
@@ -66,7 +117,6 @@ void Merge::doMerge(const QString wc)
     merge->editFromRevision->setText(Config::instance()->value(QString(KEY_LASTMERGEFROMREVISION).arg(_uuid), QVariant()).toString());
     merge->editToUrl->setText(Config::instance()->value(QString(KEY_LASTMERGETOURL).arg(_uuid), svn::Wc(0).getUrl(wc)).toString());
     merge->editToRevision->setText(Config::instance()->value(QString(KEY_LASTMERGETOREVISION).arg(_uuid), QVariant()).toString());
-    //todo: implement ShowLog to catch from* and to*
 }
 
 Merge::Merge()
@@ -77,6 +127,23 @@ Merge::Merge()
     buttonDryRun->setDefault(false);
     buttonBox->addButton(buttonDryRun, QDialogButtonBox::ActionRole);
     connect(buttonDryRun, SIGNAL(clicked()), this, SLOT(on_buttonDryRun_clicked()));
+
+    m_mergeAction = 0;
+    m_mergeJob = -1;
+    m_mergeSucceeded = false;
+    m_mergeCanceled = false;
+    m_resultModel = new MergeResultModel(this);
+    m_resultProxy = new MergeResultProxy(this);
+    m_resultProxy->setSourceModel(m_resultModel);
+    m_resultProxy->setDynamicSortFilter(true);
+    m_resultProxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    viewResult->setModel(m_resultProxy);
+    viewResult->sortByColumn(0, Qt::AscendingOrder);
+    groupBoxResult->setVisible(false);
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(REFRESH_INTERVAL);
+    connect(m_refreshTimer, SIGNAL(timeout()), this, SLOT(onRefreshResult()));
 }
 
 Merge::~Merge()
@@ -94,17 +161,117 @@ void Merge::on_buttonWcPath_clicked( )
 
 }
 
+void Merge::on_buttonEligibleRevisions_clicked()
+{
+    svn::RevisionRanges revisionRanges;
+    if (EligibleRevisions::doEligibleRevisions(this, editFromUrl->text(), editWcPath->text(),
+                                               revisionRanges))
+        setRevisionRanges(revisionRanges);
+}
+
+void Merge::setRevisionRanges(const svn::RevisionRanges &revisionRanges)
+{
+    //one range stays editable as from and to, several ranges are merged in one pass
+    if (revisionRanges.count() == 1)
+    {
+        m_revisionRanges.clear();
+        editToUrl->setText(editFromUrl->text());
+        editFromRevision->setText(QString::number(revisionRanges.at(0).first.revnum()));
+        editToRevision->setText(QString::number(revisionRanges.at(0).second.revnum()));
+        labelFromRevision->setText(tr("Revision"));
+        groupBoxFrom->setEnabled(true);
+        groupBoxTo->setEnabled(true);
+        groupBoxTo->setVisible(true);
+    }
+    else
+    {
+        m_revisionRanges = revisionRanges;
+        editFromRevision->setText(revisionRangesText(revisionRanges));
+        labelFromRevision->setText(tr("Revisions"));
+        groupBoxFrom->setEnabled(false);
+        groupBoxTo->setEnabled(false);
+        groupBoxTo->setVisible(false);
+    }
+}
+
+void Merge::invalidateResults(const QStringList &paths)
+{
+    foreach (QString key, m_resultCache.keys())
+    {
+        QString wc = key.section(QChar('\n'), 0, 0) + QDir::separator();
+        foreach (QString path, paths)
+        {
+            path = QDir::toNativeSeparators(QDir::cleanPath(path)) + QDir::separator();
+            if (path.startsWith(wc) || wc.startsWith(path))
+            {
+                m_resultCache.remove(key);
+                break;
+            }
+        }
+    }
+}
+
+QString Merge::resultKey() const
+{
+    //a dry run is only valid as long as the working copy has the same revision
+    QString wc = QDir::toNativeSeparators(QDir::cleanPath(editWcPath->text()));
+    svn::StatusPtr status = SvnClient::instance()->singleStatus(wc);
+    QStringList key;
+    key << wc
+        << editFromUrl->text() << editFromRevision->text()
+        << editToUrl->text() << editToRevision->text()
+        << QString::number(status->entry().revision());
+    return key.join("\n");
+}
+
 void Merge::accept()
 {
+    if (m_mergeAction)
+        return;
+
+    //a dry run only shows the expected result, the real merge always runs,
+    //it records svn:mergeinfo also when no content changes
+    QSvnClientMergeAction::Entries *cached = m_resultCache.object(resultKey());
+    if (cached)
+    {
+        showResult(*cached);
+        if (m_resultModel->conflictCount() > 0 &&
+            QMessageBox::question(this, tr("Merge"),
+                                  QString(tr("The dry run reported %1 conflicts.\nMerge anyway?"))
+                                          .arg(m_resultModel->conflictCount()),
+                                  QMessageBox::Yes | QMessageBox::No, QMessageBox::No) != QMessageBox::Yes)
+            return;
+    }
+
     StatusText::out(QString(tr("Merge in %1")).arg(editWcPath->text()));
-    SvnClient::instance()->merge(editFromUrl->text(),
-                                 svn::Revision(editFromRevision->text().toUInt()),
-                                 editToUrl->text(),
-                                 svn::Revision(editToRevision->text().toUInt()),
-                                 editWcPath->text(),
-                                 true, true, false, false);
-    StatusText::out(tr("Finished."));
+    startMerge(false);
+}
 
+void Merge::reject()
+{
+    //cancel a running merge first, the dialog stays open until it has stopped
+    if (m_mergeAction)
+    {
+        if (QSvnActionScheduler::instance()->cancel(m_mergeJob))
+        {
+            delete m_mergeAction;
+            m_mergeAction = 0;
+            onMergeFinished();
+        }
+        else if (!m_mergeCanceled)
+        {
+            //svn stops at its next cancel check and leaves a consistent working copy
+            m_mergeCanceled = true;
+            m_mergeAction->cancelAction();
+            updateResultLabel();
+        }
+        return;
+    }
+    QDialog::reject();
+}
+
+void Merge::saveInputValues()
+{
     const QString _uuid = SvnClient::instance()->getUUID(editWcPath->text());
     if (groupBoxWc->isEnabled())
     {
@@ -122,18 +289,191 @@ void Merge::accept()
         Config::instance()->setValue(QString(KEY_LASTMERGETOURL).arg(_uuid), editToUrl->text());
         Config::instance()->setValue(QString(KEY_LASTMERGETOREVISION).arg(_uuid), editToRevision->text());
     }
-
-    QDialog::accept();
 }
 
 void Merge::on_buttonDryRun_clicked( )
 {
+    if (m_mergeAction)
+        return;
+
+    QSvnClientMergeAction::Entries *cached = m_resultCache.object(resultKey());
+    if (cached)
+    {
+        showResult(*cached);
+        return;
+    }
+
     StatusText::out(QString(tr("Dry run in %1")).arg(editWcPath->text()));
-    SvnClient::instance()->merge(editFromUrl->text(),
-                                 svn::Revision(editFromRevision->text().toUInt()),
-                                 editToUrl->text(),
-                                 svn::Revision(editToRevision->text().toUInt()),
-                                 editWcPath->text(),
-                                 true, true, false, true);
+    startMerge(true);
+}
+
+void Merge::startMerge(bool dryRun)
+{
+    m_resultKey = resultKey();
+    m_mergeSucceeded = false;
+    m_mergeCanceled = false;
+    m_resultModel->setWcPath(editWcPath->text());
+    groupBoxResult->setVisible(true);
+    buttonDryRun->setEnabled(false);
+    buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+
+    if (m_revisionRanges.isEmpty())
+        m_mergeAction = new QSvnClientMergeAction(0,
+                                                  editFromUrl->text(),
+                                                  svn::Revision(editFromRevision->text().toUInt()),
+                                                  editToUrl->text(),
+                                                  svn::Revision(editToRevision->text().toUInt()),
+                                                  QDir::toNativeSeparators(QDir::cleanPath(editWcPath->text())),
+                                                  dryRun);
+    else
+        m_mergeAction = new QSvnClientMergeAction(0,
+                                                  editFromUrl->text(),
+                                                  m_revisionRanges,
+                                                  QDir::toNativeSeparators(QDir::cleanPath(editWcPath->text())),
+                                                  dryRun);
+    connect(m_mergeAction, SIGNAL(notify(QString, QString)), this, SLOT(onMergeNotify(QString, QString)));
+    connect(m_mergeAction, SIGNAL(finished(QString)), this, SLOT(onMergeSucceeded(QString)));
+    connect(m_mergeAction, SIGNAL(finished()), this, SLOT(onMergeFinished()));
+    connect(m_mergeAction, SIGNAL(finished()), m_mergeAction, SLOT(deleteLater()));
+    connect(m_mergeAction, SIGNAL(doGetLogin(QString,QString,QString,bool)), this, SLOT(onGetLogin(QString,QString,QString,bool)));
+    connect(m_mergeAction, SIGNAL(doGetSslServerTrustPrompt()), this, SLOT(onGetSslServerTrustPrompt()));
+
+    m_refreshTimer->start();
+    //a dry run doesn't lock the working copy
+    m_mergeJob = QSvnActionScheduler::instance()->enqueue(m_mergeAction, QSvnActionScheduler::Interactive,
+                                                          QUrl(editFromUrl->text()).host(), m_mergeAction->wcPath(),
+                                                          dryRun ? QSvnActionScheduler::Shared
+                                                                 : QSvnActionScheduler::Exclusive);
+    updateResultLabel();
+}
+
+void Merge::showResult(const QSvnClientMergeAction::Entries &entries)
+{
+    m_resultModel->setWcPath(editWcPath->text());
+    m_resultModel->appendEntries(entries);
+    groupBoxResult->setVisible(true);
+    viewResult->expandAll();
+    updateResultLabel();
+}
+
+void Merge::updateResultLabel()
+{
+    QString text = QString(tr("%1 Paths, %2 Conflicts"))
+            .arg(m_resultModel->pathCount())
+            .arg(m_resultModel->conflictCount());
+    if (m_mergeCanceled)
+        text += tr(" - canceling...");
+    else if (m_mergeAction)
+        text += m_mergeAction->isDryRun() ? tr(" - dry run...") : tr(" - merging...");
+    labelResult->setText(text);
+}
+
+void Merge::on_editFilter_textChanged(const QString &text)
+{
+    m_resultProxy->setFilterWildcard(text);
+    viewResult->expandAll();
+}
+
+void Merge::on_checkBoxConflictsOnly_toggled(bool checked)
+{
+    m_resultProxy->setConflictsOnly(checked);
+    viewResult->expandAll();
+}
+
+void Merge::onRefreshResult()
+{
+    if (!m_mergeAction)
+        return;
+
+    QSvnClientMergeAction::Entries entries = m_mergeAction->takeEntries();
+    if (entries.isEmpty())
+        return;
+
+    m_resultModel->appendEntries(entries);
+    //new children don't show up below a filtered out directory by themselves
+    if (!m_resultProxy->filterRegExp().isEmpty() || checkBoxConflictsOnly->isChecked())
+        m_resultProxy->invalidate();
+    viewResult->expandAll();
+    updateResultLabel();
+}
+
+void Merge::onMergeNotify(QString action, QString path)
+{
+    StatusText::out(QString("%1 %2").arg(action).arg(path));
+}
+
+void Merge::onMergeSucceeded(QString path)
+{
+    m_mergeSucceeded = true;
+}
+
+void Merge::onMergeFinished()
+{
+    m_refreshTimer->stop();
+    onRefreshResult();
+    bool dryRun = m_mergeAction ? m_mergeAction->isDryRun() : true;
+    bool canceled = m_mergeCanceled;
+    m_mergeAction = 0;
+    m_mergeJob = -1;
+    m_mergeCanceled = false;
+    buttonDryRun->setEnabled(true);
+    buttonBox->button(QDialogButtonBox::Ok)->setEnabled(true);
+    updateResultLabel();
+
+    if (!m_mergeSucceeded)
+    {
+        //a stopped merge may have changed parts of the working copy
+        if (!dryRun)
+            invalidateResults(QStringList(editWcPath->text()));
+        if (canceled)
+            StatusText::out(dryRun ? tr("Dry run canceled.")
+                                   : tr("Merge canceled, the working copy may be merged partially."));
+        return;
+    }
+
+    if (dryRun)
+    {
+        QSvnClientMergeAction::Entries entries = m_resultModel->entries();
+        m_resultCache.insert(m_resultKey, new QSvnClientMergeAction::Entries(entries), qMax(entries.count(), 1));
+        StatusText::out(tr("Finished."));
+        if (m_resultModel->conflictCount() > 0)
+            QMessageBox::warning(this, tr("Merge"),
+                                 QString(tr("The merge will produce %1 conflicts.")).arg(m_resultModel->conflictCount()));
+        return;
+    }
+
     StatusText::out(tr("Finished."));
+    invalidateResults(QStringList(editWcPath->text()));
+    saveInputValues();
+    //keep the dialog open, so the conflicts can be looked up
+    if (m_resultModel->conflictCount() > 0)
+    {
+        buttonDryRun->setEnabled(false);
+        buttonBox->button(QDialogButtonBox::Ok)->setEnabled(false);
+        buttonBox->button(QDialogButtonBox::Cancel)->setText(tr("Close"));
+        checkBoxConflictsOnly->setChecked(true);
+    }
+    else
+        QDialog::accept();
+}
+
+void Merge::onGetLogin(QString realm, QString username, QString password, bool maySave)
+{
+    QSvnClientMergeAction *action = qobject_cast<QSvnClientMergeAction*>(sender());
+    if (!action)
+        return;
+
+    if (Login::doLogin(this, realm, username, password, maySave))
+        action->endGetLogin(username, password, maySave);
+    else
+        action->abortEmit();
+}
+
+void Merge::onGetSslServerTrustPrompt()
+{
+    QSvnClientMergeAction *action = qobject_cast<QSvnClientMergeAction*>(sender());
+    if (!action)
+        return;
+
+    action->endGetSslServerTrustPrompt(SslServerTrust::getSslServerTrustAnswer(action->getSslServerTrustData()));
 }
@@ -24,11 +24,17 @@
 //QSvn
 #include "svnclient.h"
 #include "ui_merge.h"
+#include "qsvnactions/qsvnclientmergeaction.h"
+
+class MergeResultModel;
+class MergeResultProxy;
 
 //Qt
+#include <QCache>
 #include <QDialog>
 
 class QPushButton;
+class QTimer;
 
 
 class Merge : public QDialog, public Ui::Merge
@@ -40,11 +46,23 @@ class Merge : public QDialog, public Ui::Merge
                             const QString toURL, const svn::Revision toRevision,
                             const QString wc);
         static void doMerge(const QString wc);
+        /**
+         * Merge several revision ranges of url in one pass, e.g. to cherry-pick revisions.
+         */
+        static void doMerge(const QString url, const svn::RevisionRanges &revisionRanges,
+                            const QString wc);
+
+        /**
+         * Drop the cached dry runs of working copies containing or below one of paths.
+         */
+        static void invalidateResults(const QStringList &paths);
 
     public slots:
         void on_buttonWcPath_clicked();
         void on_buttonDryRun_clicked();
+        void on_buttonEligibleRevisions_clicked();
         void accept();
+        void reject();
 
     private:
         Merge();
@@ -52,6 +70,36 @@ class Merge : public QDialog, public Ui::Merge
 
         QPushButton *buttonDryRun;
 
+        //results of dry runs by resultKey()
+        static QCache<QString, QSvnClientMergeAction::Entries> m_resultCache;
+
+        MergeResultModel *m_resultModel;
+        MergeResultProxy *m_resultProxy;
+        QSvnClientMergeAction *m_mergeAction;
+        int m_mergeJob;
+        bool m_mergeSucceeded;
+        bool m_mergeCanceled;
+        QString m_resultKey;
+        QTimer *m_refreshTimer;
+        svn::RevisionRanges m_revisionRanges; //instead of from and to, if not empty
+
+        QString resultKey() const;
+        static QString revisionRangesText(const svn::RevisionRanges &revisionRanges);
+        void setRevisionRanges(const svn::RevisionRanges &revisionRanges);
+        void startMerge(bool dryRun);
+        void showResult(const QSvnClientMergeAction::Entries &entries);
+        void updateResultLabel();
+        void saveInputValues();
+
+    private slots:
+        void on_editFilter_textChanged(const QString &text);
+        void on_checkBoxConflictsOnly_toggled(bool checked);
+        void onRefreshResult();
+        void onMergeNotify(QString action, QString path);
+        void onMergeSucceeded(QString path);
+        void onMergeFinished();
+        void onGetLogin(QString realm, QString username, QString password, bool maySave);
+        void onGetSslServerTrustPrompt();
 };
 
 #endif
@@ -0,0 +1,330 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "mergeresultmodel.h"
+#include "mergeresultmodel.moc"
+
+//Qt
+#include <QtGui>
+
+#include <svn_version.h>
+
+
+MergeResultModel::MergeResultModel(QObject *parent)
+        : QAbstractItemModel(parent)
+{
+    m_root = new Node;
+    m_root->row = 0;
+    m_root->parent = 0;
+    m_root->hasEntry = false;
+    m_pathCount = 0;
+    m_conflictCount = 0;
+}
+
+MergeResultModel::~MergeResultModel()
+{
+    deleteNode(m_root);
+}
+
+QModelIndex MergeResultModel::index(int row, int column, const QModelIndex &parent) const
+{
+    Node *parentNode = parent.isValid() ? static_cast<Node*>(parent.internalPointer()) : m_root;
+    if (row < 0 || row >= parentNode->children.count() || column < 0 || column >= columnCount())
+        return QModelIndex();
+    return createIndex(row, column, parentNode->children.at(row));
+}
+
+QModelIndex MergeResultModel::parent(const QModelIndex &index) const
+{
+    if (!index.isValid())
+        return QModelIndex();
+
+    Node *node = static_cast<Node*>(index.internalPointer());
+    if (node->parent == m_root)
+        return QModelIndex();
+    return indexOf(node->parent, 0);
+}
+
+int MergeResultModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.column() > 0)
+        return 0;
+    Node *parentNode = parent.isValid() ? static_cast<Node*>(parent.internalPointer()) : m_root;
+    return parentNode->children.count();
+}
+
+int MergeResultModel::columnCount(const QModelIndex &parent) const
+{
+    return 4;
+}
+
+QVariant MergeResultModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    {
+        switch (section)
+        {
+            case 0:
+                return QString(tr("Path"));
+                break;
+            case 1:
+                return QString(tr("Action"));
+                break;
+            case 2:
+                return QString(tr("Content"));
+                break;
+            case 3:
+                return QString(tr("Properties"));
+                break;
+        }
+    }
+    return QVariant();
+}
+
+QVariant MergeResultModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    Node *node = static_cast<Node*>(index.internalPointer());
+    if (role == Qt::DisplayRole)
+    {
+        if (index.column() == 0)
+            return node->name;
+        if (!node->hasEntry)
+            return QVariant();
+
+        switch (index.column())
+        {
+            case 1:
+                return node->entry.treeConflict ? tr("Tree conflict") : actionName(node->entry.action);
+                break;
+            case 2:
+                return stateName(node->entry.contentState);
+                break;
+            case 3:
+                return stateName(node->entry.propState);
+                break;
+        }
+    }
+    else if (role == Qt::ToolTipRole && node->hasEntry)
+        return node->entry.path;
+    else if (role == Qt::ForegroundRole && node->hasEntry && QSvnClientMergeAction::isConflict(node->entry))
+        return QBrush(Qt::red);
+    else if (role == Qt::DecorationRole && index.column() == 0)
+    {
+        if (node->hasEntry && QSvnClientMergeAction::isConflict(node->entry))
+            return QIcon(":/images/conflictedfile.png");
+        else if (node->hasEntry && node->entry.kind == svn_node_file)
+            return QIcon(":/images/file.png");
+        else
+            return QIcon(":/images/folder.png");
+    }
+    return QVariant();
+}
+
+void MergeResultModel::setWcPath(const QString &wcPath)
+{
+    clear();
+    m_wcPath = QDir::toNativeSeparators(QDir::cleanPath(wcPath));
+}
+
+void MergeResultModel::clear()
+{
+    foreach (Node *node, m_root->children)
+        deleteNode(node);
+    m_root->children.clear();
+    m_root->childByName.clear();
+    m_entries.clear();
+    m_pathCount = 0;
+    m_conflictCount = 0;
+    reset();
+}
+
+void MergeResultModel::appendEntries(const QSvnClientMergeAction::Entries &entries)
+{
+    foreach (QSvnClientMergeAction::Entry entry, entries)
+    {
+        m_entries << entry;
+        Node *node = nodeFor(entry.path);
+
+        //several notifications for one path are combined into one row
+        if (!node->hasEntry)
+        {
+            node->hasEntry = true;
+            node->entry = entry;
+            ++m_pathCount;
+        }
+        else
+        {
+            if (QSvnClientMergeAction::isConflict(node->entry))
+                --m_conflictCount;
+            if (!entry.treeConflict)
+                node->entry.action = entry.action;
+            if (entry.kind != svn_node_none && entry.kind != svn_node_unknown)
+                node->entry.kind = entry.kind;
+            if (entry.contentState > svn_wc_notify_state_unknown)
+                node->entry.contentState = entry.contentState;
+            if (entry.propState > svn_wc_notify_state_unknown)
+                node->entry.propState = entry.propState;
+            node->entry.treeConflict = node->entry.treeConflict || entry.treeConflict;
+        }
+        if (QSvnClientMergeAction::isConflict(node->entry))
+            ++m_conflictCount;
+        emit dataChanged(indexOf(node, 0), indexOf(node, columnCount() - 1));
+    }
+}
+
+QSvnClientMergeAction::Entries MergeResultModel::entries() const
+{
+    return m_entries;
+}
+
+int MergeResultModel::pathCount() const
+{
+    return m_pathCount;
+}
+
+int MergeResultModel::conflictCount() const
+{
+    return m_conflictCount;
+}
+
+bool MergeResultModel::hasEntry(const QModelIndex &index) const
+{
+    return index.isValid() && static_cast<Node*>(index.internalPointer())->hasEntry;
+}
+
+bool MergeResultModel::isConflict(const QModelIndex &index) const
+{
+    if (!hasEntry(index))
+        return false;
+    return QSvnClientMergeAction::isConflict(static_cast<Node*>(index.internalPointer())->entry);
+}
+
+MergeResultModel::Node *MergeResultModel::nodeFor(const QString &path)
+{
+    Node *node = childNode(m_root, m_wcPath);
+    QString relativePath = path;
+    if (relativePath == m_wcPath)
+        return node;
+    if (relativePath.startsWith(m_wcPath + QDir::separator()))
+        relativePath = relativePath.mid(m_wcPath.length() + 1);
+
+    foreach (QString name, relativePath.split(QDir::separator(), QString::SkipEmptyParts))
+        node = childNode(node, name);
+    return node;
+}
+
+MergeResultModel::Node *MergeResultModel::childNode(Node *parent, const QString &name)
+{
+    Node *node = parent->childByName.value(name);
+    if (node)
+        return node;
+
+    //new rows are appended, the view sorts them through the proxy
+    node = new Node;
+    node->name = name;
+    node->row = parent->children.count();
+    node->parent = parent;
+    node->hasEntry = false;
+
+    beginInsertRows(parent == m_root ? QModelIndex() : indexOf(parent, 0), node->row, node->row);
+    parent->children << node;
+    parent->childByName.insert(name, node);
+    endInsertRows();
+    return node;
+}
+
+QModelIndex MergeResultModel::indexOf(Node *node, int column) const
+{
+    if (node == m_root)
+        return QModelIndex();
+    return createIndex(node->row, column, node);
+}
+
+void MergeResultModel::deleteNode(Node *node)
+{
+    foreach (Node *child, node->children)
+        deleteNode(child);
+    delete node;
+}
+
+QString MergeResultModel::actionName(svn_wc_notify_action_t action)
+{
+    switch (action)
+    {
+        case svn_wc_notify_update_add:
+            return tr("Added");
+            break;
+        case svn_wc_notify_update_delete:
+            return tr("Deleted");
+            break;
+        case svn_wc_notify_update_update:
+            return tr("Updated");
+            break;
+        case svn_wc_notify_update_replace:
+            return tr("Replaced");
+            break;
+        case svn_wc_notify_skip:
+            return tr("Skipped");
+            break;
+        case svn_wc_notify_exists:
+            return tr("Exists");
+            break;
+#if SVN_VER_MAJOR == 1 && SVN_VER_MINOR >= 6
+        case svn_wc_notify_tree_conflict:
+            return tr("Tree conflict");
+            break;
+#endif
+        default:
+            return QString();
+            break;
+    }
+}
+
+QString MergeResultModel::stateName(svn_wc_notify_state_t state)
+{
+    switch (state)
+    {
+        case svn_wc_notify_state_unchanged:
+            return tr("unchanged");
+            break;
+        case svn_wc_notify_state_missing:
+            return tr("missing");
+            break;
+        case svn_wc_notify_state_obstructed:
+            return tr("obstructed");
+            break;
+        case svn_wc_notify_state_changed:
+            return tr("changed");
+            break;
+        case svn_wc_notify_state_merged:
+            return tr("merged");
+            break;
+        case svn_wc_notify_state_conflicted:
+            return tr("conflicted");
+            break;
+        default:
+            return QString();
+            break;
+    }
+}
@@ -0,0 +1,91 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef MERGERESULTMODEL_H
+#define MERGERESULTMODEL_H
+
+//QSvn
+#include "qsvnactions/qsvnclientmergeaction.h"
+
+//Qt
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+
+
+/**
+The notifications of a merge as a tree of the paths below the working copy.
+The working copy is the only top level item.
+*/
+class MergeResultModel : public QAbstractItemModel
+{
+        Q_OBJECT
+
+    public:
+        MergeResultModel(QObject *parent);
+        ~MergeResultModel();
+
+        QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
+        QModelIndex parent(const QModelIndex &index) const;
+        int rowCount(const QModelIndex &parent = QModelIndex()) const;
+        int columnCount(const QModelIndex &parent = QModelIndex()) const;
+        QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+        QVariant data(const QModelIndex &index, int role) const;
+
+        void setWcPath(const QString &wcPath);
+        void clear();
+        void appendEntries(const QSvnClientMergeAction::Entries &entries);
+
+        /**
+         * All entries appended since the last clear(), e.g. to cache them.
+         */
+        QSvnClientMergeAction::Entries entries() const;
+        int pathCount() const;
+        int conflictCount() const;
+        bool hasEntry(const QModelIndex &index) const;
+        bool isConflict(const QModelIndex &index) const;
+
+    private:
+        struct Node
+        {
+            QString name;
+            int row;
+            Node *parent;
+            QList<Node*> children;
+            QHash<QString, Node*> childByName;
+            bool hasEntry;
+            QSvnClientMergeAction::Entry entry;
+        };
+
+        Node *m_root; //invisible root, holds the working copy
+        QString m_wcPath;
+        QSvnClientMergeAction::Entries m_entries;
+        int m_pathCount;
+        int m_conflictCount;
+
+        Node *nodeFor(const QString &path);
+        Node *childNode(Node *parent, const QString &name);
+        QModelIndex indexOf(Node *node, int column) const;
+        void deleteNode(Node *node);
+        static QString actionName(svn_wc_notify_action_t action);
+        static QString stateName(svn_wc_notify_state_t state);
+};
+
+#endif
@@ -0,0 +1,63 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "mergeresultmodel.h"
+#include "mergeresultproxy.h"
+#include "mergeresultproxy.moc"
+
+//Qt
+#include <QtCore>
+#include <QSortFilterProxyModel>
+
+MergeResultProxy::MergeResultProxy(QObject *parent)
+        : QSortFilterProxyModel(parent)
+{
+    m_conflictsOnly = false;
+    #if defined Q_WS_WIN32
+    setSortCaseSensitivity(Qt::CaseInsensitive);
+    #endif
+}
+
+void MergeResultProxy::setConflictsOnly(bool conflictsOnly)
+{
+    m_conflictsOnly = conflictsOnly;
+    invalidateFilter();
+}
+
+bool MergeResultProxy::filterAcceptsRow(int source_row, const QModelIndex &source_parent) const
+{
+    MergeResultModel *model = static_cast<MergeResultModel*>(sourceModel());
+    QModelIndex index = model->index(source_row, 0, source_parent);
+
+    if (model->hasEntry(index) && (!m_conflictsOnly || model->isConflict(index)))
+    {
+        if (filterRegExp().isEmpty() ||
+            model->data(index, Qt::ToolTipRole).toString().contains(filterRegExp()))
+            return true;
+    }
+
+    for (int row = 0; row < model->rowCount(index); ++row)
+    {
+        if (filterAcceptsRow(row, index))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,130 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "notifyentriesmodel.h"
+#include "notifyentriesmodel.moc"
+
+//Qt
+#include <QtCore>
+
+
+NotifyEntriesModel::NotifyEntriesModel(QObject *parent)
+        : QAbstractTableModel(parent)
+{
+}
+
+NotifyEntriesModel::~NotifyEntriesModel()
+{
+}
+
+int NotifyEntriesModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    else
+        return m_entries.count();
+}
+
+int NotifyEntriesModel::columnCount(const QModelIndex &parent) const
+{
+    return 2;
+}
+
+QVariant NotifyEntriesModel::headerData(int section,
+                                        Qt::Orientation orientation,
+                                        int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    {
+        switch (section)
+        {
+            case 0:
+                return QString(tr("Action"));
+                break;
+            case 1:
+                return QString(tr("Path"));
+                break;
+        }
+    }
+    return QVariant();
+}
+
+QVariant NotifyEntriesModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole)
+        return QVariant();
+
+    const Entry &entry = m_entries.at(index.row());
+    switch (index.column())
+    {
+        case 0:
+            return m_actions.at(entry.action);
+            break;
+        case 1:
+            return entry.path;
+            break;
+    }
+    return QVariant();
+}
+
+void NotifyEntriesModel::appendEntries(const QList<NotifyEntry> &entries)
+{
+    if (entries.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), m_entries.count(), m_entries.count() + entries.count() - 1);
+    m_entries.reserve(m_entries.count() + entries.count());
+    foreach (const NotifyEntry &notifyEntry, entries)
+    {
+        Entry entry;
+        QHash<QString, int>::const_iterator it = m_actionIndex.constFind(notifyEntry.first);
+        if (it == m_actionIndex.constEnd())
+        {
+            entry.action = m_actions.count();
+            m_actionIndex.insert(notifyEntry.first, entry.action);
+            m_actions << notifyEntry.first;
+            m_actionCounts << 0;
+        }
+        else
+            entry.action = it.value();
+        entry.path = notifyEntry.second;
+        m_actionCounts[entry.action]++;
+        m_entries.append(entry);
+    }
+    endInsertRows();
+}
+
+void NotifyEntriesModel::clear()
+{
+    m_entries.clear();
+    m_actions.clear();
+    m_actionIndex.clear();
+    m_actionCounts.clear();
+    reset();
+}
+
+QHash<QString, int> NotifyEntriesModel::actionCounts() const
+{
+    QHash<QString, int> counts;
+    for (int i = 0; i < m_actions.count(); ++i)
+        counts.insert(m_actions.at(i), m_actionCounts.at(i));
+    return counts;
+}
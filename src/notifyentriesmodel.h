@@ -0,0 +1,74 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef NOTIFYENTRIESMODEL_H
+#define NOTIFYENTRIESMODEL_H
+
+//Qt
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+
+typedef QPair<QString, QString> NotifyEntry; //action, path
+
+/**
+Holds the notifications from a running QSvnAction.
+Entries are appended in batches, so that the view only has to
+handle one insert for a lot of notifications.
+*/
+
+class NotifyEntriesModel : public QAbstractTableModel
+{
+        Q_OBJECT
+
+    public:
+        NotifyEntriesModel(QObject *parent);
+        ~NotifyEntriesModel();
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const;
+        int columnCount(const QModelIndex &parent = QModelIndex()) const;
+        QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+        QVariant data(const QModelIndex &index, int role) const;
+
+        void appendEntries(const QList<NotifyEntry> &entries);
+        void clear();
+
+        /**
+         * Returns the number of notifications for every action.
+         */
+        QHash<QString, int> actionCounts() const;
+
+    private:
+        struct Entry
+        {
+            int action; //index in m_actions
+            QString path;
+        };
+
+        QVector<Entry> m_entries;
+        QStringList m_actions;
+        QHash<QString, int> m_actionIndex;
+        QVector<int> m_actionCounts;
+};
+
+#endif
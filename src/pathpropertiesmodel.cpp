@@ -40,6 +40,7 @@ PathPropertiesModel::PathPropertiesModel(QObject *parent, const QString path)
     {
         m_propMap = svn::PropertiesMap();
     }
+    m_propNames = m_propMap.keys();
 }
 
 PathPropertiesModel::~PathPropertiesModel()
@@ -86,10 +87,10 @@ QVariant PathPropertiesModel::data(const QModelIndex &index, int role) const
         switch (index.column())
         {
             case 0:
-                return m_propMap.keys().at(index.row());
+                return m_propNames.at(index.row());
                 break;
             case 1:
-                return m_propMap[m_propMap.keys().at(index.row())];
+                return m_propMap.value(m_propNames.at(index.row()));
                 break;
             default:
                 return QVariant();
@@ -104,6 +105,7 @@ void PathPropertiesModel::addProperty(const QString propertyName, const QString
 {
     beginInsertRows(QModelIndex(), rowCount(), rowCount() + 1);
     m_propMap.insert(propertyName, propertyValue);
+    m_propNames = m_propMap.keys();
     endInsertRows();
 }
 
@@ -113,6 +115,7 @@ void PathPropertiesModel::setProperty(const QString propertyName, const QString
         m_propMap[propertyName] = propertyValue;
     else
         m_propMap.insert(propertyName, propertyValue);
+    m_propNames = m_propMap.keys();
     emit layoutChanged();
 }
 
@@ -120,15 +123,21 @@ void PathPropertiesModel::deleteProperty(const QItemSelectionModel &selection)
 {
     if (selection.hasSelection())
     {
+        QStringList names;
         QModelIndexList indexList = selection.selectedIndexes();
         Q_FOREACH(const QModelIndex &idx, indexList)
         {
             if (idx.column() == 0)
-            {
-                beginRemoveRows(QModelIndex(), idx.row(), idx.row());
-                m_propMap.remove(this->data(idx, Qt::DisplayRole).toString());
-                endRemoveRows();
-            }
+                names << m_propNames.at(idx.row());
+        }
+        //rows move up with every removal, so look them up by name
+        foreach (QString name, names)
+        {
+            int row = m_propNames.indexOf(name);
+            beginRemoveRows(QModelIndex(), row, row);
+            m_propMap.remove(name);
+            m_propNames.removeAt(row);
+            endRemoveRows();
         }
     }
 }
@@ -140,10 +149,10 @@ void PathPropertiesModel::writeProperties()
 
 QString PathPropertiesModel::getPropertyName(int row)
 {
-    return m_propMap.keys().at(row);
+    return m_propNames.at(row);
 }
 
 QString PathPropertiesModel::getPropertyValue(int row)
 {
-    return m_propMap[m_propMap.keys().at(row)];
+    return m_propMap.value(m_propNames.at(row));
 }
@@ -53,6 +53,7 @@ class PathPropertiesModel : public QAbstractTableModel
     private:
         QString m_path;
         svn::PropertiesMap m_propMap;
+        QStringList m_propNames; //keys of m_propMap, data() needs them for every cell
 };
 
 #endif
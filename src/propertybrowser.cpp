@@ -0,0 +1,277 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "config.h"
+#include "login.h"
+#include "propertybrowser.h"
+#include "propertybrowser.moc"
+#include "propertybrowsermodel.h"
+#include "propertyedit.h"
+#include "sslservertrust.h"
+#include "statustext.h"
+#include "svnclient.h"
+#include "qsvnactions/qsvnactionscheduler.h"
+#include "qsvnactions/qsvnclientproplistaction.h"
+#include "qsvnactions/qsvnclientpropsetaction.h"
+
+#include "svnqt/status.hpp"
+
+//Qt
+#include <QtGui>
+
+
+PropertyBrowser::PropertyBrowser(QWidget *parent, const QString path)
+    : QDialog(0), m_path(path), m_listAction(0), m_listJob(-1), m_setAction(0)
+{
+    setAttribute(Qt::WA_DeleteOnClose, true);
+    setupUi(this);
+
+    buttonSet = new QPushButton(this);
+    buttonSet->setText(tr("Set..."));
+    this->buttonBox->addButton(buttonSet, QDialogButtonBox::ActionRole);
+    connect(buttonSet, SIGNAL(clicked()), this, SLOT(buttonSetClicked()));
+
+    buttonDelete = new QPushButton(this);
+    buttonDelete->setText(tr("Delete"));
+    this->buttonBox->addButton(buttonDelete, QDialogButtonBox::ActionRole);
+    connect(buttonDelete, SIGNAL(clicked()), this, SLOT(buttonDeleteClicked()));
+
+    this->setWindowTitle(QString(tr("Browse Properties for %1")).arg(path));
+
+    m_model = new PropertyBrowserModel(this);
+    m_proxy = new QSortFilterProxyModel(this);
+    m_proxy->setSourceModel(m_model);
+    m_proxy->setDynamicSortFilter(true);
+    m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    m_proxy->setFilterKeyColumn(1);
+    viewProperties->setModel(m_proxy);
+    connect(viewProperties->selectionModel(), SIGNAL(selectionChanged(const QItemSelection &, const QItemSelection &)),
+            this, SLOT(updateButtons()));
+    connect(viewProperties, SIGNAL(doubleClicked(const QModelIndex &)),
+            this, SLOT(buttonSetClicked()));
+
+    Config::instance()->restoreWidget(this);
+    Config::instance()->restoreHeaderView(this, viewProperties->header());
+
+    m_listAction = new QSvnClientPropListAction(0, path, svn::DepthInfinity);
+    connect(m_listAction, SIGNAL(entriesRead()), this, SLOT(onEntriesRead()));
+    connect(m_listAction, SIGNAL(finished()), this, SLOT(onListFinished()));
+    connect(m_listAction, SIGNAL(finished()), m_listAction, SLOT(deleteLater()));
+    connect(m_listAction, SIGNAL(notify(QString, QString)), this, SLOT(onNotify(QString, QString)));
+    connect(m_listAction, SIGNAL(doGetLogin(QString,QString,QString,bool)), this, SLOT(onGetLogin(QString,QString,QString,bool)));
+    connect(m_listAction, SIGNAL(doGetSslServerTrustPrompt()), this, SLOT(onGetSslServerTrustPrompt()));
+    m_listJob = QSvnActionScheduler::instance()->enqueue(m_listAction, QSvnActionScheduler::Interactive,
+                                                         QString(), path, QSvnActionScheduler::Shared);
+
+    updateButtons();
+    updateStatus();
+}
+
+PropertyBrowser::~PropertyBrowser()
+{
+    Config::instance()->saveWidget(this);
+    Config::instance()->saveHeaderView(this, viewProperties->header());
+
+    //a running list stops before its next directory and deletes itself, a running propset is completed
+    if (m_listAction)
+    {
+        disconnect(m_listAction, 0, this, 0);
+        if (QSvnActionScheduler::instance()->cancel(m_listJob))
+            delete m_listAction;
+        else
+            m_listAction->cancelAction();
+    }
+    if (m_setAction)
+        disconnect(m_setAction, 0, this, 0);
+}
+
+void PropertyBrowser::doPropertyBrowser(QWidget *parent, const QString path)
+{
+    svn::StatusPtr status = SvnClient::instance()->singleStatus(path);
+    if (status->isVersioned())
+    {
+        PropertyBrowser *propertyBrowser = new PropertyBrowser(parent, path);
+        propertyBrowser->show();
+        propertyBrowser->raise();
+        propertyBrowser->activateWindow();
+    }
+    else
+    {
+        StatusText::out(QString("Path %1 is not versioned").arg(path));
+    }
+}
+
+QList<int> PropertyBrowser::selectedRows() const
+{
+    QList<int> rows;
+    foreach (QModelIndex index, viewProperties->selectionModel()->selectedRows())
+        rows << m_proxy->mapToSource(index).row();
+    return rows;
+}
+
+void PropertyBrowser::startPropSet(QSvnClientPropSetAction *action)
+{
+    m_setAction = action;
+    connect(m_setAction, SIGNAL(finished()), this, SLOT(onSetFinished()));
+    connect(m_setAction, SIGNAL(finished()), m_setAction, SLOT(deleteLater()));
+    connect(m_setAction, SIGNAL(notify(QString, QString)), this, SLOT(onNotify(QString, QString)));
+    QSvnActionScheduler::instance()->enqueue(m_setAction, QSvnActionScheduler::Interactive,
+                                             QString(), m_path);
+    updateButtons();
+    updateStatus();
+}
+
+void PropertyBrowser::updateStatus()
+{
+    QString status = tr("%1 Properties on %2 Paths").arg(m_model->rowCount()).arg(m_model->pathCount());
+    if (m_proxy->rowCount() != m_model->rowCount())
+        status += tr(", %1 shown").arg(m_proxy->rowCount());
+    if (m_listAction)
+        status += tr(" - reading...");
+    if (m_setAction)
+        status += tr(" - writing...");
+    labelStatus->setText(status);
+}
+
+void PropertyBrowser::on_comboFilterColumn_activated(int index)
+{
+    //the combo box lists Name, Value, Path
+    static const int columns[] = { 1, 2, 0 };
+    m_proxy->setFilterKeyColumn(columns[index]);
+    updateStatus();
+}
+
+void PropertyBrowser::on_editFilter_textChanged(const QString &text)
+{
+    m_proxy->setFilterWildcard(text);
+    updateStatus();
+}
+
+void PropertyBrowser::onEntriesRead()
+{
+    if (m_listAction)
+        m_model->appendEntries(m_listAction->takeEntries());
+    updateStatus();
+}
+
+void PropertyBrowser::onListFinished()
+{
+    onEntriesRead();
+    m_listAction = 0;
+    m_listJob = -1;
+    updateStatus();
+}
+
+void PropertyBrowser::onSetFinished()
+{
+    if (m_setAction)
+        m_model->applyChanges(m_setAction->appliedChanges());
+    m_setAction = 0;
+    updateButtons();
+    updateStatus();
+}
+
+void PropertyBrowser::onNotify(QString action, QString path)
+{
+    StatusText::out(QString("%1 %2").arg(action).arg(path));
+}
+
+void PropertyBrowser::onGetLogin(QString realm, QString username, QString password, bool maySave)
+{
+    QSvnClientAction *action = qobject_cast<QSvnClientAction*>(sender());
+    if (!action)
+        return;
+
+    if (Login::doLogin(this, realm, username, password, maySave))
+        action->endGetLogin(username, password, maySave);
+    else
+        action->abortEmit();
+}
+
+void PropertyBrowser::onGetSslServerTrustPrompt()
+{
+    QSvnClientAction *action = qobject_cast<QSvnClientAction*>(sender());
+    if (!action)
+        return;
+
+    action->endGetSslServerTrustPrompt(SslServerTrust::getSslServerTrustAnswer(action->getSslServerTrustData()));
+}
+
+void PropertyBrowser::buttonSetClicked()
+{
+    QList<int> rows = selectedRows();
+    if (rows.isEmpty() || m_setAction)
+        return;
+
+    QString _propName = m_model->name(rows.first());
+    QString _propValue = m_model->value(rows.first());
+    if (PropertyEdit::doPropertyEdit(this, _propName, _propValue) != QDialog::Accepted)
+        return;
+
+    //the property is set once on every selected path
+    QSvnClientPropSetAction::Changes changes;
+    QSet<QString> paths;
+    foreach (int row, rows)
+    {
+        QString path = m_model->path(row);
+        if (paths.contains(path))
+            continue;
+        paths.insert(path);
+
+        QSvnClientPropSetAction::Change change;
+        change.path = path;
+        change.name = _propName;
+        change.value = _propValue;
+        change.remove = false;
+        changes << change;
+    }
+    startPropSet(new QSvnClientPropSetAction(0, changes));
+}
+
+void PropertyBrowser::buttonDeleteClicked()
+{
+    QList<int> rows = selectedRows();
+    if (rows.isEmpty() || m_setAction)
+        return;
+
+    if (QMessageBox::question(this, tr("Delete Properties"),
+                              tr("Delete %1 selected Properties?").arg(rows.count()),
+                              QMessageBox::Yes | QMessageBox::No, QMessageBox::No) != QMessageBox::Yes)
+        return;
+
+    QSvnClientPropSetAction::Changes changes;
+    foreach (int row, rows)
+    {
+        QSvnClientPropSetAction::Change change;
+        change.path = m_model->path(row);
+        change.name = m_model->name(row);
+        change.remove = true;
+        changes << change;
+    }
+    startPropSet(new QSvnClientPropSetAction(0, changes));
+}
+
+void PropertyBrowser::updateButtons()
+{
+    bool hasSelection = viewProperties->selectionModel()->hasSelection();
+    buttonSet->setEnabled(hasSelection && !m_setAction);
+    buttonDelete->setEnabled(hasSelection && !m_setAction);
+}
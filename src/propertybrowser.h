@@ -0,0 +1,79 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef PROPERTYBROWSER_H
+#define PROPERTYBROWSER_H
+
+//QSvn
+#include "ui_propertybrowser.h"
+
+class PropertyBrowserModel;
+class QSvnClientPropListAction;
+class QSvnClientPropSetAction;
+
+//Qt
+#include <QDialog>
+
+class QPushButton;
+class QSortFilterProxyModel;
+
+
+/**
+Shows the properties of a path and all versioned paths below and sets or
+deletes them on many paths at once.
+*/
+class PropertyBrowser : public QDialog, public Ui::PropertyBrowser
+{
+        Q_OBJECT
+
+    public:
+        PropertyBrowser(QWidget *parent, const QString path);
+        ~PropertyBrowser();
+
+        static void doPropertyBrowser(QWidget *parent, const QString path);
+
+    private:
+        QString m_path;
+        PropertyBrowserModel *m_model;
+        QSortFilterProxyModel *m_proxy;
+        QSvnClientPropListAction *m_listAction;
+        int m_listJob;
+        QSvnClientPropSetAction *m_setAction;
+        QPushButton *buttonSet, *buttonDelete;
+
+        QList<int> selectedRows() const;
+        void startPropSet(QSvnClientPropSetAction *action);
+        void updateStatus();
+
+    private slots:
+        void on_comboFilterColumn_activated(int index);
+        void on_editFilter_textChanged(const QString &text);
+        void onEntriesRead();
+        void onListFinished();
+        void onSetFinished();
+        void onNotify(QString action, QString path);
+        void onGetLogin(QString realm, QString username, QString password, bool maySave);
+        void onGetSslServerTrustPrompt();
+        void buttonSetClicked();
+        void buttonDeleteClicked();
+        void updateButtons();
+};
+
+#endif
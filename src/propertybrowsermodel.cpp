@@ -0,0 +1,288 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "propertybrowsermodel.h"
+#include "propertybrowsermodel.moc"
+
+//Qt
+#include <QtCore>
+
+//up to this count of removed row ranges the view is told about every range, above it is reset
+#define MAX_REMOVE_RANGES 16
+
+
+PropertyBrowserModel::PropertyBrowserModel(QObject *parent)
+        : QAbstractTableModel(parent)
+{
+}
+
+PropertyBrowserModel::~PropertyBrowserModel()
+{
+}
+
+int PropertyBrowserModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    else
+        return m_pathColumn.count();
+}
+
+int PropertyBrowserModel::columnCount(const QModelIndex &parent) const
+{
+    return 3;
+}
+
+QVariant PropertyBrowserModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole)
+    {
+        switch (section)
+        {
+            case 0:
+                return QString(tr("Path"));
+                break;
+            case 1:
+                return QString(tr("Name"));
+                break;
+            case 2:
+                return QString(tr("Value"));
+                break;
+        }
+    }
+    return QVariant();
+}
+
+QVariant PropertyBrowserModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+        return QVariant();
+
+    if (role == Qt::DisplayRole || role == Qt::ToolTipRole)
+    {
+        switch (index.column())
+        {
+            case 0:
+                return path(index.row());
+                break;
+            case 1:
+                return name(index.row());
+                break;
+            case 2:
+                return value(index.row());
+                break;
+        }
+    }
+    return QVariant();
+}
+
+void PropertyBrowserModel::clear()
+{
+    m_pathColumn.clear();
+    m_nameColumn.clear();
+    m_valueColumn.clear();
+    m_strings.clear();
+    m_stringIndex.clear();
+    m_rows.clear();
+    m_paths.clear();
+    reset();
+}
+
+void PropertyBrowserModel::appendEntries(const svn::PathPropertiesMapList &entries)
+{
+    int count = 0;
+    foreach (svn::PathPropertiesMapEntry entry, entries)
+        count += entry.second.count();
+    if (count == 0)
+        return;
+
+    beginInsertRows(QModelIndex(), rowCount(), rowCount() + count - 1);
+    foreach (svn::PathPropertiesMapEntry entry, entries)
+    {
+        QString path = QDir::toNativeSeparators(entry.first);
+        int pathIndex = stringIndex(path);
+        m_paths.insert(pathIndex);
+
+        QMapIterator<QString, QString> it(entry.second);
+        while (it.hasNext())
+        {
+            it.next();
+            m_rows.insert(rowKey(path, it.key()), m_pathColumn.count());
+            m_pathColumn.append(pathIndex);
+            m_nameColumn.append(stringIndex(it.key()));
+            m_valueColumn.append(stringIndex(it.value()));
+        }
+    }
+    endInsertRows();
+}
+
+void PropertyBrowserModel::applyChanges(const QSvnClientPropSetAction::Changes &changes)
+{
+    QSet<int> removedRows;
+    int firstChanged = -1, lastChanged = -1;
+    QVector<int> newPaths, newNames, newValues; //value -1 for a new row removed again
+    QHash<QString, int> newRows;
+    foreach (QSvnClientPropSetAction::Change change, changes)
+    {
+        QString path = QDir::toNativeSeparators(change.path);
+        QString key = rowKey(path, change.name);
+        int row = m_rows.value(key, -1);
+        if (change.remove)
+        {
+            if (row >= 0)
+                removedRows.insert(row);
+            else if (newRows.contains(key))
+                newValues[newRows.value(key)] = -1;
+        }
+        else if (row >= 0)
+        {
+            removedRows.remove(row);
+            m_valueColumn[row] = stringIndex(change.value);
+            firstChanged = (firstChanged < 0) ? row : qMin(firstChanged, row);
+            lastChanged = qMax(lastChanged, row);
+        }
+        else if (newRows.contains(key))
+            newValues[newRows.value(key)] = stringIndex(change.value);
+        else
+        {
+            newRows.insert(key, newPaths.count());
+            newPaths.append(stringIndex(path));
+            newNames.append(stringIndex(change.name));
+            newValues.append(stringIndex(change.value));
+        }
+    }
+
+    if (firstChanged >= 0)
+        emit dataChanged(index(firstChanged, 2), index(lastChanged, 2));
+
+    int newCount = newValues.count() - newValues.count(-1);
+    if (newCount > 0)
+    {
+        beginInsertRows(QModelIndex(), rowCount(), rowCount() + newCount - 1);
+        for (int i = 0; i < newValues.count(); ++i)
+        {
+            if (newValues.at(i) < 0)
+                continue;
+            m_rows.insert(rowKey(m_strings.at(newPaths.at(i)), m_strings.at(newNames.at(i))), m_pathColumn.count());
+            m_pathColumn.append(newPaths.at(i));
+            m_nameColumn.append(newNames.at(i));
+            m_valueColumn.append(newValues.at(i));
+            m_paths.insert(newPaths.at(i));
+        }
+        endInsertRows();
+    }
+
+    if (removedRows.isEmpty())
+        return;
+
+    //contiguous ranges of removed rows
+    QList<int> rows = removedRows.toList();
+    qSort(rows);
+    QList<QPair<int, int> > ranges;
+    foreach (int row, rows)
+    {
+        if (!ranges.isEmpty() && ranges.last().second == row - 1)
+            ranges.last().second = row;
+        else
+            ranges << qMakePair(row, row);
+    }
+
+    if (ranges.count() <= MAX_REMOVE_RANGES)
+    {
+        //remove from the end, so the other ranges stay valid
+        for (int i = ranges.count() - 1; i >= 0; --i)
+        {
+            int first = ranges.at(i).first;
+            int count = ranges.at(i).second - first + 1;
+            beginRemoveRows(QModelIndex(), first, first + count - 1);
+            m_pathColumn.remove(first, count);
+            m_nameColumn.remove(first, count);
+            m_valueColumn.remove(first, count);
+            endRemoveRows();
+        }
+    }
+    else
+    {
+        //compact the columns in one pass, scattered removals would move the tail every time
+        int target = 0;
+        for (int row = 0; row < m_pathColumn.count(); ++row)
+        {
+            if (removedRows.contains(row))
+                continue;
+            m_pathColumn[target] = m_pathColumn.at(row);
+            m_nameColumn[target] = m_nameColumn.at(row);
+            m_valueColumn[target] = m_valueColumn.at(row);
+            ++target;
+        }
+        m_pathColumn.resize(target);
+        m_nameColumn.resize(target);
+        m_valueColumn.resize(target);
+        reset();
+    }
+    updateRowIndex();
+}
+
+QString PropertyBrowserModel::path(int row) const
+{
+    return m_strings.at(m_pathColumn.at(row));
+}
+
+QString PropertyBrowserModel::name(int row) const
+{
+    return m_strings.at(m_nameColumn.at(row));
+}
+
+QString PropertyBrowserModel::value(int row) const
+{
+    return m_strings.at(m_valueColumn.at(row));
+}
+
+int PropertyBrowserModel::pathCount() const
+{
+    return m_paths.count();
+}
+
+int PropertyBrowserModel::stringIndex(const QString &string)
+{
+    QHash<QString, int>::const_iterator it = m_stringIndex.constFind(string);
+    if (it != m_stringIndex.constEnd())
+        return it.value();
+
+    m_strings.append(string);
+    m_stringIndex.insert(string, m_strings.count() - 1);
+    return m_strings.count() - 1;
+}
+
+QString PropertyBrowserModel::rowKey(const QString &path, const QString &name)
+{
+    return path + QChar('\n') + name;
+}
+
+void PropertyBrowserModel::updateRowIndex()
+{
+    m_rows.clear();
+    m_paths.clear();
+    for (int row = 0; row < m_pathColumn.count(); ++row)
+    {
+        m_rows.insert(rowKey(path(row), name(row)), row);
+        m_paths.insert(m_pathColumn.at(row));
+    }
+}
@@ -0,0 +1,82 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef PROPERTYBROWSERMODEL_H
+#define PROPERTYBROWSERMODEL_H
+
+//QSvn
+#include "qsvnactions/qsvnclientpropsetaction.h"
+
+//SvnQt
+#include "svnqt/svnqttypes.hpp"
+
+//Qt
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QVector>
+
+
+/**
+One row for every property of every path. The model is filled in batches
+while the properties are read.
+*/
+class PropertyBrowserModel : public QAbstractTableModel
+{
+        Q_OBJECT
+
+    public:
+        PropertyBrowserModel(QObject *parent);
+        ~PropertyBrowserModel();
+
+        int rowCount(const QModelIndex &parent = QModelIndex()) const;
+        int columnCount(const QModelIndex &parent = QModelIndex()) const;
+        QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const;
+        QVariant data(const QModelIndex &index, int role) const;
+
+        void clear();
+        void appendEntries(const svn::PathPropertiesMapList &entries);
+        /**
+         * Take over written changes, without reading the properties again.
+         */
+        void applyChanges(const QSvnClientPropSetAction::Changes &changes);
+
+        QString path(int row) const;
+        QString name(int row) const;
+        QString value(int row) const;
+        int pathCount() const;
+
+    private:
+        //one vector per column, every string is stored only once in m_strings
+        QVector<int> m_pathColumn;
+        QVector<int> m_nameColumn;
+        QVector<int> m_valueColumn;
+        QStringList m_strings;
+        QHash<QString, int> m_stringIndex;
+        QHash<QString, int> m_rows; //row by rowKey()
+        QSet<int> m_paths;
+
+        int stringIndex(const QString &string);
+        static QString rowKey(const QString &path, const QString &name);
+        void updateRowIndex();
+};
+
+#endif
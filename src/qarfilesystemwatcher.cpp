@@ -24,58 +24,420 @@
 #include <QFileSystemWatcher>
 #include <QtCore>
 
+#if defined Q_OS_LINUX
+#include <errno.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#define WATCH_MASK (IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | \
+                    IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW)
+#endif
+
 #if defined Q_WS_WIN32
 #include <windows.h>
+#endif
+
+//changes are reported when no further change came for this time in milliseconds
+#define DEFAULT_DEBOUNCE_INTERVAL 300
+//a continuous stream of changes is reported at least this often in milliseconds
+#define MAX_DEBOUNCE_DELAY 2000
+
+
+//QarFileSystemScanner
+QarFileSystemScanner::QarFileSystemScanner(QarFileSystemWatcher *watcher)
+    : QThread(watcher)
+{
+    m_watcher = watcher;
+    m_limitReached = false;
+}
+
+void QarFileSystemScanner::enqueue(const QString &dir)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_queue.contains(dir))
+        m_queue.append(dir);
+}
+
+bool QarFileSystemScanner::hasPending()
+{
+    QMutexLocker locker(&m_mutex);
+    return !m_queue.isEmpty();
+}
+
+void QarFileSystemScanner::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_queue.clear();
+    m_directories.clear();
+}
+
+QStringList QarFileSystemScanner::takeDirectories()
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList directories = m_directories;
+    m_directories.clear();
+    return directories;
+}
+
+bool QarFileSystemScanner::limitReached()
+{
+    QMutexLocker locker(&m_mutex);
+    bool limitReached = m_limitReached;
+    m_limitReached = false;
+    return limitReached;
+}
+
+void QarFileSystemScanner::run()
+{
+    QList<QRegExp> patterns = m_watcher->ignoreRegExps();
 
+    forever
+    {
+        m_mutex.lock();
+        if (m_queue.isEmpty())
+        {
+            m_mutex.unlock();
+            return;
+        }
+        QStringList stack(m_queue.takeFirst());
+        m_mutex.unlock();
+
+        while (!stack.isEmpty())
+        {
+            QString dir = stack.takeLast();
+#if defined Q_OS_LINUX
+            if (!m_watcher->watchDirectory(dir))
+            {
+                QMutexLocker locker(&m_mutex);
+                m_limitReached = true;
+                m_queue.clear();
+                return;
+            }
+#else
+            m_mutex.lock();
+            m_directories.append(dir);
+            m_mutex.unlock();
+#endif
+            foreach (QString name, QDir(dir).entryList(QDir::Dirs | QDir::NoDotAndDotDot |
+                                                       QDir::Hidden | QDir::NoSymLinks, QDir::Unsorted))
+            {
+                if (!QarFileSystemWatcher::isIgnored(name, patterns))
+                    stack.append(dir + "/" + name);
+            }
+        }
+    }
+}
+
+
+//QarFileSystemWatcher
 QarFileSystemWatcher::QarFileSystemWatcher(QObject *parent)
-    : QFileSystemWatcher(parent)
+    : QObject(parent)
 {
-    m_fsWatcher = this;
+    m_inotifyFd = -1;
+    m_notifier = 0;
+
+    m_debounceTimer = new QTimer(this);
+    m_debounceTimer->setSingleShot(true);
+    m_debounceInterval = DEFAULT_DEBOUNCE_INTERVAL;
+    connect(m_debounceTimer, SIGNAL(timeout()), this, SLOT(onDebounceTimeout()));
+
+    m_scanner = new QarFileSystemScanner(this);
+    connect(m_scanner, SIGNAL(finished()), this, SLOT(onScanFinished()));
+
+    setIgnorePatterns(QStringList());
+
+#if defined Q_OS_LINUX
+    m_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (m_inotifyFd >= 0)
+    {
+        m_notifier = new QSocketNotifier(m_inotifyFd, QSocketNotifier::Read, this);
+        connect(m_notifier, SIGNAL(activated(int)), this, SLOT(onReadEvents()));
+    }
+    else
+        qWarning("QarFileSystemWatcher: inotify_init failed");
+#endif
 }
 
 QarFileSystemWatcher::~QarFileSystemWatcher()
 {
+    m_scanner->clear();
+    m_scanner->wait();
     qDeleteAll(m_fsWatcherList);
+#if defined Q_OS_LINUX
+    if (m_inotifyFd >= 0)
+        close(m_inotifyFd);
+#endif
 }
 
-void QarFileSystemWatcher::addPaths(const QStringList &paths)
+void QarFileSystemWatcher::addPath(const QString &path)
 {
-    int _count = m_fsWatcher->directories().count() +
-            m_fsWatcher->files().count();
-    QStringList _paths;
+    QString root = QDir::cleanPath(QDir::fromNativeSeparators(path));
+    m_mutex.lock();
+    if (m_roots.contains(root))
+    {
+        m_mutex.unlock();
+        return;
+    }
+    m_roots.append(root);
+    m_mutex.unlock();
 
-    foreach(QString path, paths)
+    m_scanner->enqueue(root);
+    m_scanner->start(QThread::LowPriority);
+}
+
+void QarFileSystemWatcher::removePath(const QString &path)
+{
+    QString root = QDir::cleanPath(QDir::fromNativeSeparators(path));
+    m_mutex.lock();
+    bool isRoot = m_roots.removeAll(root);
+    m_mutex.unlock();
+    if (isRoot)
+        unwatchDirectories(root);
+}
+
+void QarFileSystemWatcher::removeAllPaths()
+{
+    foreach (QString root, roots())
+        removePath(root);
+}
+
+QStringList QarFileSystemWatcher::roots() const
+{
+    return m_roots;
+}
+
+int QarFileSystemWatcher::count()
+{
+    QMutexLocker locker(&m_mutex);
+    int count = m_pathWds.count();
+    foreach (QFileSystemWatcher *fsWatcher, m_fsWatcherList)
+        count += fsWatcher->directories().count();
+    return count;
+}
+
+void QarFileSystemWatcher::setIgnorePatterns(const QStringList &patterns)
+{
+    m_mutex.lock();
+    m_ignorePatterns = patterns;
+    m_ignorePatterns.removeAll("");
+    m_ignorePatterns << ".svn" << "_svn";
+    m_mutex.unlock();
+
+    m_ignoreRegExps = ignoreRegExps();
+}
+
+void QarFileSystemWatcher::setDebounceInterval(int msec)
+{
+    m_debounceInterval = msec;
+}
+
+QList<QRegExp> QarFileSystemWatcher::ignoreRegExps()
+{
+    QMutexLocker locker(&m_mutex);
+    QList<QRegExp> regExps;
+    foreach (QString pattern, m_ignorePatterns)
+        regExps << QRegExp(pattern, Qt::CaseSensitive, QRegExp::Wildcard);
+    return regExps;
+}
+
+bool QarFileSystemWatcher::isIgnored(const QString &name, const QList<QRegExp> &patterns)
+{
+    for (int i = 0; i < patterns.count(); ++i)
     {
-        _count++;
-        _paths << path;
+        if (patterns.at(i).exactMatch(name))
+            return true;
+    }
+    return false;
+}
 
-        if (_count > MAXIMUM_WAIT_OBJECTS)
+bool QarFileSystemWatcher::isUnderRoot(const QString &dir) const
+{
+    foreach (QString root, m_roots)
+    {
+        if (dir == root || dir.startsWith(root + "/"))
+            return true;
+    }
+    return false;
+}
+
+bool QarFileSystemWatcher::watchDirectory(const QString &dir)
+{
+#if defined Q_OS_LINUX
+    QMutexLocker locker(&m_mutex);
+    if (m_inotifyFd < 0 || m_pathWds.contains(dir) || !isUnderRoot(dir))
+        return true;
+
+    int wd = inotify_add_watch(m_inotifyFd, QFile::encodeName(dir).constData(), WATCH_MASK);
+    if (wd < 0)
+        return errno != ENOSPC;
+
+    m_wdPaths.insert(wd, dir);
+    m_pathWds.insert(dir, wd);
+#endif
+    return true;
+}
+
+void QarFileSystemWatcher::unwatchDirectories(const QString &path)
+{
+    QString prefix = path + "/";
+#if defined Q_OS_LINUX
+    QMutexLocker locker(&m_mutex);
+    QMutableHashIterator<QString, int> it(m_pathWds);
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.key() == path || it.key().startsWith(prefix))
         {
-            m_fsWatcher->addPaths(_paths);
-            m_fsWatcher = new QFileSystemWatcher();
-            connect(m_fsWatcher, SIGNAL(directoryChanged(const QString &)),
-                this, SIGNAL(directoryChanged(const QString &)));
-            connect(m_fsWatcher, SIGNAL(fileChanged(const QString &)),
-                this, SIGNAL(fileChanged(const QString &)));
-            m_fsWatcherList.append(m_fsWatcher);
-            _paths.clear();
-            _count = 0;
+            inotify_rm_watch(m_inotifyFd, it.value());
+            m_wdPaths.remove(it.value());
+            it.remove();
         }
     }
-    if (!_paths.isEmpty())
-        m_fsWatcher->addPaths(_paths);
-}
+#else
+    foreach (QFileSystemWatcher *fsWatcher, m_fsWatcherList)
+    {
+        QStringList directories;
+        foreach (QString dir, fsWatcher->directories())
+        {
+            if (QDir::fromNativeSeparators(dir) == path ||
+                QDir::fromNativeSeparators(dir).startsWith(prefix))
+                directories << dir;
+        }
+        if (!directories.isEmpty())
+            fsWatcher->removePaths(directories);
+    }
 #endif
+}
 
-void QarFileSystemWatcher::removeAllPaths()
+void QarFileSystemWatcher::onScanFinished()
 {
+    //directories found by the fall back are watched from the gui thread
+    QStringList directories = m_scanner->takeDirectories();
+    while (!directories.isEmpty())
+    {
+        QFileSystemWatcher *fsWatcher = m_fsWatcherList.isEmpty() ? 0 : m_fsWatcherList.last();
+        int capacity = directories.count();
 #if defined Q_WS_WIN32
-    qDeleteAll(m_fsWatcherList);
-    m_fsWatcherList.clear();
-    m_fsWatcher = this;
+        //every QFileSystemWatcher on windows is limited to MAXIMUM_WAIT_OBJECTS handles
+        if (fsWatcher)
+            capacity = qMin(capacity, MAXIMUM_WAIT_OBJECTS - 1 - fsWatcher->directories().count());
+        else
+            capacity = 0;
+#endif
+        if (!fsWatcher || capacity <= 0)
+        {
+            fsWatcher = new QFileSystemWatcher();
+            connect(fsWatcher, SIGNAL(directoryChanged(const QString &)),
+                    this, SLOT(onDirectoryChanged(const QString &)));
+            m_fsWatcherList.append(fsWatcher);
+            continue;
+        }
+
+        QStringList chunk = directories.mid(0, capacity);
+        directories = directories.mid(capacity);
+        m_mutex.lock();
+        for (int i = chunk.count() - 1; i >= 0; --i)
+        {
+            if (!isUnderRoot(chunk.at(i)))
+                chunk.removeAt(i);
+        }
+        m_mutex.unlock();
+        if (!chunk.isEmpty())
+            fsWatcher->addPaths(chunk);
+    }
+
+    if (m_scanner->limitReached())
+    {
+        qWarning("QarFileSystemWatcher: no more directories can be watched (%d watched)", count());
+        emit overflow(roots());
+    }
+
+    //directories enqueued while the scanner was about to finish
+    if (m_scanner->hasPending())
+        m_scanner->start(QThread::LowPriority);
+}
+
+void QarFileSystemWatcher::onReadEvents()
+{
+#if defined Q_OS_LINUX
+    //aligned for the events, as in inotify(7)
+    char buffer[64 * 1024] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    bool overflowed = false;
+    ssize_t length;
+
+    while ((length = read(m_inotifyFd, buffer, sizeof(buffer))) > 0)
+    {
+        ssize_t offset = 0;
+        while (offset < length)
+        {
+            const struct inotify_event *event = (const struct inotify_event *) (buffer + offset);
+            offset += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                overflowed = true;
+                continue;
+            }
+
+            m_mutex.lock();
+            QString dir = m_wdPaths.value(event->wd);
+            if (event->mask & IN_IGNORED)
+            {
+                m_wdPaths.remove(event->wd);
+                if (m_pathWds.value(dir, -1) == event->wd)
+                    m_pathWds.remove(dir);
+            }
+            m_mutex.unlock();
+            if (dir.isEmpty() || (event->mask & IN_IGNORED))
+                continue;
+
+            QString name = event->len ? QFile::decodeName(event->name) : QString();
+            if (event->mask & IN_ISDIR)
+            {
+                if (isIgnored(name, m_ignoreRegExps))
+                    continue;
+
+                QString subdir = dir + "/" + name;
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                {
+                    m_scanner->enqueue(subdir);
+                    m_scanner->start(QThread::LowPriority);
+                }
+                else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+                    unwatchDirectories(subdir);
+            }
+            addChangedPath(name.isEmpty() ? dir : dir + "/" + name);
+        }
+    }
+
+    if (overflowed)
+    {
+        qWarning("QarFileSystemWatcher: inotify queue overflow, changes got lost");
+        emit overflow(roots());
+    }
 #endif
-    if (!directories().isEmpty())
-        removePaths(directories());
-    if (!files().isEmpty())
-        removePaths(files());
+}
+
+void QarFileSystemWatcher::onDirectoryChanged(const QString &dir)
+{
+    addChangedPath(QDir::fromNativeSeparators(dir));
+}
+
+void QarFileSystemWatcher::addChangedPath(const QString &path)
+{
+    if (m_changedPaths.isEmpty())
+        m_firstChange.start();
+    m_changedPaths.insert(QDir::toNativeSeparators(path));
+
+    //wait until the changes settle, but not longer than the maximum delay after the first one
+    int remaining = qMax(MAX_DEBOUNCE_DELAY, m_debounceInterval) - m_firstChange.elapsed();
+    m_debounceTimer->start(qBound(0, remaining, m_debounceInterval));
+}
+
+void QarFileSystemWatcher::onDebounceTimeout()
+{
+    QStringList paths = m_changedPaths.toList();
+    m_changedPaths.clear();
+    paths.sort();
+    emit pathsChanged(paths);
 }
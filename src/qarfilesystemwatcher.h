@@ -23,25 +23,107 @@
 
 #include <QtCore>
 
-class QarFileSystemWatcher : public QFileSystemWatcher
+class QarFileSystemWatcher;
+
+
+/**
+Collects the directories below the watched roots in a background thread.
+*/
+class QarFileSystemScanner : public QThread
+{
+    public:
+        QarFileSystemScanner(QarFileSystemWatcher *watcher);
+
+        void enqueue(const QString &dir);
+        bool hasPending();
+        void clear();
+        QStringList takeDirectories();
+        bool limitReached();
+
+    protected:
+        void run();
+
+    private:
+        QarFileSystemWatcher *m_watcher;
+        QMutex m_mutex;
+        QStringList m_queue;
+        QStringList m_directories;
+        bool m_limitReached;
+};
+
+
+/**
+Watches directory trees recursively. Changes are collected over a short
+interval and reported together. On Linux inotify is used directly, other
+platforms fall back to QFileSystemWatcher.
+*/
+class QarFileSystemWatcher : public QObject
 {
         Q_OBJECT
 
-    public:
-        void removeAllPaths();
+        friend class QarFileSystemScanner;
 
-#if defined Q_WS_WIN32
+    public:
         QarFileSystemWatcher(QObject *parent = 0);
         ~QarFileSystemWatcher();
 
-        void addPaths(const QStringList &paths);
+        /**
+         * Watch a directory and all its subdirectories.
+         */
+        void addPath(const QString &path);
+        void removePath(const QString &path);
+        void removeAllPaths();
+        QStringList roots() const;
+        int count();
+
+        /**
+         * Directories matching one of the wildcard patterns are not watched. .svn is always ignored.
+         */
+        void setIgnorePatterns(const QStringList &patterns);
+        void setDebounceInterval(int msec);
+
+    signals:
+        /**
+         * Changed files and directories, reported when no change came for the debounce interval
+         * or at least every MAX_DEBOUNCE_DELAY while changes go on.
+         */
+        void pathsChanged(const QStringList &paths);
+        /**
+         * Changes got lost or not all directories could be watched.
+         * The roots have to be read again completely.
+         */
+        void overflow(const QStringList &roots);
+
+    private slots:
+        void onReadEvents();
+        void onDirectoryChanged(const QString &dir);
+        void onScanFinished();
+        void onDebounceTimeout();
 
     private:
-        QList<QFileSystemWatcher*> m_fsWatcherList;
-        QFileSystemWatcher *m_fsWatcher;
+        QStringList m_roots;
+        QStringList m_ignorePatterns;
+        QList<QRegExp> m_ignoreRegExps; //only for the gui thread, QRegExp is not thread safe
+        QSet<QString> m_changedPaths;
+        QTimer *m_debounceTimer;
+        int m_debounceInterval;
+        QTime m_firstChange; //of the changes collected in m_changedPaths
+        QarFileSystemScanner *m_scanner;
+        QMutex m_mutex;
 
-#endif
+        int m_inotifyFd;
+        QSocketNotifier *m_notifier;
+        QHash<int, QString> m_wdPaths;
+        QHash<QString, int> m_pathWds;
+
+        QList<QFileSystemWatcher*> m_fsWatcherList;
 
+        QList<QRegExp> ignoreRegExps();
+        static bool isIgnored(const QString &name, const QList<QRegExp> &patterns);
+        bool isUnderRoot(const QString &dir) const;
+        bool watchDirectory(const QString &dir); //false if no more watches are possible
+        void unwatchDirectories(const QString &path);
+        void addChangedPath(const QString &path);
 };
 
 
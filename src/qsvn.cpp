@@ -22,12 +22,15 @@
 #include "checkout.h"
 #include "config.h"
 #include "configure.h"
+#include "diskremover.h"
 #include "filelistproxy.h"
 #include "filemodifier.h"
 #include "fileselector.h"
 #include "helper.h"
 #include "merge.h"
 #include "pathproperties.h"
+#include "propertybrowser.h"
+#include "qarfilesystemwatcher.h"
 #include "qsvn_defines.h"
 #include "qsvn.h"
 #include "qsvn.moc"
@@ -45,6 +48,8 @@
 //Qt
 #include <QtGui>
 
+//count of failed paths reported after removing working copies from disk
+#define MAX_REMOVE_ERRORS 10
 
 QSvn::QSvn(QWidget *parent, Qt::WFlags flags)
         : QMainWindow(parent, flags)
@@ -88,6 +93,19 @@ QSvn::QSvn(QWidget *parent, Qt::WFlags flags)
 
     connect(treeViewWorkingCopy, SIGNAL(collapsed(const QModelIndex &)),
             wcModel, SLOT(doCollapse(const QModelIndex &)));
+    connect(m_statusEntriesModel, SIGNAL(statusRead(const QString &, const svn::StatusEntries &)),
+            wcModel, SLOT(updateStatus(const QString &, const svn::StatusEntries &)));
+    connect(m_statusEntriesModel, SIGNAL(statusChanged(const QStringList &, const svn::StatusEntries &)),
+            wcModel, SLOT(updateStatus(const QStringList &, const svn::StatusEntries &)));
+
+    //refresh automatically on changes in the working copies
+    m_fsWatcher = new QarFileSystemWatcher(this);
+    m_diskRemover = 0;
+    m_diskRemoverStop = false;
+    connect(m_fsWatcher, SIGNAL(pathsChanged(const QStringList &)),
+            this, SLOT(onPathsChanged(const QStringList &)));
+    connect(m_fsWatcher, SIGNAL(overflow(const QStringList &)),
+            this, SLOT(onWatcherOverflow(const QStringList &)));
 
     connect(actionExit, SIGNAL(triggered()), this, SLOT(close()));
 
@@ -95,6 +113,9 @@ QSvn::QSvn(QWidget *parent, Qt::WFlags flags)
     Config::instance()->restoreHeaderView(this, treeViewFileList->header());
 
     applyConfigurations();
+
+    foreach (QString wc, wcModel->workingCopies())
+        m_fsWatcher->addPath(wc);
 }
 
 void QSvn::onSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected)
@@ -110,6 +131,7 @@ QSvn::~QSvn()
 {
     Config::instance()->saveMainWindow(this);
     Config::instance()->saveHeaderView(this, treeViewFileList->header());
+    Config::instance()->flush();
     Config::instance()->removeTempDir();
 }
 
@@ -129,6 +151,7 @@ void QSvn::createMenus()
     contextMenuWorkingCopy->addAction(actionDelete);
     contextMenuWorkingCopy->addAction(actionMkDir);
     contextMenuWorkingCopy->addAction(actionEditProperties);
+    contextMenuWorkingCopy->addAction(actionBrowseProperties);
     contextMenuWorkingCopy->addSeparator();
     contextMenuWorkingCopy->addAction(actionWcRemoveFromFavorites);
     contextMenuWorkingCopy->addAction(actionWcRemoveFromDisk);
@@ -150,12 +173,15 @@ void QSvn::createMenus()
     contextMenuFileList->addAction(actionFlMove);
     contextMenuFileList->addAction(actionFlCopy);
     contextMenuFileList->addAction(actionEditProperties);
+    contextMenuFileList->addAction(actionBrowseProperties);
     contextMenuFileList->addSeparator();
     contextMenuFileList->addAction(actionFlRemoveFromDisk);
 }
 
 void QSvn::applyConfigurations()
 {
+    m_fsWatcher->setIgnorePatterns(Config::instance()->value(KEY_WATCHERIGNORE).toString().split(";"));
+
     if (Config::instance()->value(KEY_SHOWTEXTINTOOLBAR).toBool())
         toolBarToolbar->setToolButtonStyle(Qt::ToolButtonTextUnderIcon);
     else
@@ -243,10 +269,14 @@ QStringList QSvn::selectedPaths()
 
 void QSvn::setActionStop(QString aText)
 {
+    //a synchronous svn operation takes Stop over from a running removal and gives it back afterwards
+    m_diskRemoverStop = false;
+    disconnect(actionStop, SIGNAL(triggered()), 0, 0);
     if (aText.isEmpty())
     {
         actionStop->setText("");
-        disconnect(actionStop, SIGNAL(triggered()), 0, 0);
+        if (m_diskRemover)
+            setDiskRemoverStop();
     }
     else
     {
@@ -255,7 +285,7 @@ void QSvn::setActionStop(QString aText)
                 SvnClient::instance(), SLOT(setCancel()));
     }
 
-    actionStop->setEnabled(!aText.isEmpty());
+    actionStop->setEnabled(!aText.isEmpty() || m_diskRemoverStop);
 
     qApp->processEvents();
 }
@@ -266,6 +296,21 @@ void QSvn::directoryChanged(const QString &dir)
         m_statusEntriesModel->readDirectory(m_currentWCpath, svn::DepthFiles, true);
 }
 
+void QSvn::onPathsChanged(const QStringList &paths)
+{
+    //the file list only knows its own rows, the tree rolls up changes anywhere in the working copies
+    invalidatePaths(paths);
+}
+
+void QSvn::onWatcherOverflow(const QStringList &roots)
+{
+    //changes got lost, read everything again
+    directoryChanged(m_currentWCpath);
+    Merge::invalidateResults(roots);
+    foreach (QString root, roots)
+        wcModel->scanStatus(root);
+}
+
 //private slots
 void QSvn::on_actionWcAdd_triggered()
 {
@@ -275,7 +320,10 @@ void QSvn::on_actionWcAdd_triggered()
                   QFileDialog::ShowDirsOnly);
 
     if (!dir.isEmpty())
+    {
         wcModel->insertWc(dir);
+        m_fsWatcher->addPath(dir);
+    }
 }
 
 void QSvn::on_actionWcRemoveFromFavorites_triggered()
@@ -288,6 +336,7 @@ void QSvn::on_actionWcRemoveFromFavorites_triggered()
                   QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes)
         {
             wcModel->removeWc(path);
+            m_fsWatcher->removePath(path);
 			directoryChanged("");
         }
     }
@@ -295,6 +344,13 @@ void QSvn::on_actionWcRemoveFromFavorites_triggered()
 
 void QSvn::on_actionWcRemoveFromDisk_triggered()
 {
+    if (m_diskRemover)
+    {
+        StatusText::out(tr("Another working copy is still being removed from disk."));
+        return;
+    }
+
+    QStringList removePaths;
     foreach(QString path, selectedPaths())
     {
         if (QMessageBox::question(this,
@@ -303,10 +359,71 @@ void QSvn::on_actionWcRemoveFromDisk_triggered()
                   QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes)
         {
             wcModel->removeWc(path);
+            m_fsWatcher->removePath(path);
 			directoryChanged("");
-            Helper::removeFromDisk(path);
+            removePaths << path;
+        }
+    }
+    if (removePaths.isEmpty())
+        return;
+
+    //the working copies are renamed at once and removed in the background
+    m_diskRemover = new DiskRemover(this, removePaths, true);
+    connect(m_diskRemover, SIGNAL(progress(int)), this, SLOT(onDiskRemoverProgress(int)));
+    connect(m_diskRemover, SIGNAL(finished()), this, SLOT(onDiskRemoverFinished()));
+    if (!actionStop->isEnabled())
+        setDiskRemoverStop();
+    StatusText::out(QString(tr("Remove from disk: %1")).arg(removePaths.join(", ")));
+    m_diskRemover->start();
+}
+
+void QSvn::onDiskRemoverProgress(int removedEntries)
+{
+    if (m_diskRemover && m_diskRemoverStop)
+        actionStop->setText(QString(tr("Stop Remove from Disk (%1 removed)")).arg(removedEntries));
+}
+
+void QSvn::setDiskRemoverStop()
+{
+    actionStop->setText(QString(tr("Stop Remove from Disk (%1 removed)")).arg(m_diskRemover->removedEntries()));
+    connect(actionStop, SIGNAL(triggered()), m_diskRemover, SLOT(cancel()));
+    actionStop->setEnabled(true);
+    m_diskRemoverStop = true;
+}
+
+void QSvn::onDiskRemoverFinished()
+{
+    if (!m_diskRemover)
+        return;
+
+    QStringList failedPaths = m_diskRemover->failedPaths();
+    if (m_diskRemover->isCanceled())
+        StatusText::out(QString(tr("Remove from disk canceled after %1 entries.")).arg(m_diskRemover->removedEntries()));
+    else
+        StatusText::out(QString(tr("Removed %1 entries from disk.")).arg(m_diskRemover->removedEntries()));
+
+    //only the first errors, a locked directory fails for everything above it too
+    for (int i = 0; i < qMin(failedPaths.count(), MAX_REMOVE_ERRORS); ++i)
+        StatusText::out(QString(tr("Error while remove from disk: %1")).arg(failedPaths.at(i)));
+    if (failedPaths.count() > MAX_REMOVE_ERRORS)
+        StatusText::out(QString(tr("... and %1 more errors")).arg(failedPaths.count() - MAX_REMOVE_ERRORS));
+
+    //the rest of a canceled or failed removal is still in the renamed trees
+    if (m_diskRemover->isCanceled() || !failedPaths.isEmpty())
+    {
+        foreach (QString trash, m_diskRemover->trashPaths())
+        {
+            QFileInfo fileInfo(trash);
+            if (fileInfo.exists() || fileInfo.isSymLink())
+                StatusText::out(QString(tr("Not removed from disk: %1")).arg(QDir::toNativeSeparators(trash)));
         }
     }
+
+    m_diskRemover->deleteLater();
+    m_diskRemover = 0;
+    //Stop may belong to a synchronous svn operation running meanwhile
+    if (m_diskRemoverStop)
+        setActionStop("");
 }
 
 void QSvn::on_actionWcCheckout_triggered()
@@ -321,10 +438,11 @@ void QSvn::on_actionWcCheckout_triggered()
 void QSvn::on_actionUpdate_triggered()
 {
     setActionStop("Update");
+    SvnClient::instance()->takeTouchedPaths();
     SvnClient::instance()->update(selectedPaths(), isFileListSelected());
     setActionStop("");
 
-    directoryChanged(m_currentWCpath);
+    invalidatePaths(SvnClient::instance()->takeTouchedPaths());
 }
 
 void QSvn::on_actionCommit_triggered()
@@ -351,8 +469,9 @@ void QSvn::on_actionAdd_triggered()
             else
             {
                 //Add unversioned directory to repository
+                SvnClient::instance()->takeTouchedPaths();
                 SvnClient::instance()->add(path, svn::DepthEmpty);
-                wcModel->updateWc(path);
+                invalidatePaths(SvnClient::instance()->takeTouchedPaths());
             }
         }
     }
@@ -434,6 +553,7 @@ void QSvn::on_actionFlResolved_triggered()
         QStringList resolveList = selectedPaths();
 
         setActionStop("Resolve");
+        SvnClient::instance()->takeTouchedPaths();
 
         for (int i = 0; i < resolveList.count(); i++)
         {
@@ -447,7 +567,7 @@ void QSvn::on_actionFlResolved_triggered()
 
         setActionStop("Resolved finished");
 
-        directoryChanged(m_currentWCpath);
+        invalidatePaths(SvnClient::instance()->takeTouchedPaths());
     }
 }
 
@@ -501,6 +621,14 @@ void QSvn::on_actionEditProperties_triggered()
     }
 }
 
+void QSvn::on_actionBrowseProperties_triggered()
+{
+    foreach(QString path, selectedPaths())
+    {
+        PropertyBrowser::doPropertyBrowser(this, path);
+    }
+}
+
 void QSvn::on_actionFlRemoveFromDisk_triggered()
 {
     if (isFileListSelected())
@@ -515,12 +643,19 @@ void QSvn::on_actionMerge_triggered()
     }
 }
 
-void QSvn::updateWc(const QString dir)
+void QSvn::invalidatePaths(const QStringList &paths)
 {
-    wcModel->updateWc(dir);
+    if (paths.isEmpty())
+        return;
+
+    if (!m_currentWCpath.isEmpty())
+        m_statusEntriesModel->updatePaths(paths);
+    wcModel->invalidatePaths(paths);
+    Merge::invalidateResults(paths);
 }
 
 void QSvn::onQSvnClientCheckoutActionFinished(QString path)
 {
     wcModel->insertWc(path);
+    m_fsWatcher->addPath(path);
 }
@@ -24,8 +24,12 @@
 //QSvn
 #include "ui_qsvn.h"
 
+class DiskRemover;
+
 class FileListProxy;
 
+class QarFileSystemWatcher;
+
 class StatusEntriesModel;
 
 class WcModel;
@@ -42,7 +46,11 @@ class QSvn : public QMainWindow, public Ui::QSvn
         QSvn(QWidget *parent = 0, Qt::WFlags flags = 0);
         ~QSvn();
 
-        void updateWc(const QString dir);
+        /**
+         * Read only the changed paths again after an action, e.g. the ones
+         * from SvnClient::takeTouchedPaths(), or after a change on disk.
+         */
+        void invalidatePaths(const QStringList &paths);
 
     protected:
         bool eventFilter(QObject *watched, QEvent *event);
@@ -57,10 +65,14 @@ class QSvn : public QMainWindow, public Ui::QSvn
         WcModel *wcModel;
         FileListProxy *m_fileListProxy;
         StatusEntriesModel *m_statusEntriesModel;
+        QarFileSystemWatcher *m_fsWatcher;
+        DiskRemover *m_diskRemover; //running removal of working copies
+        bool m_diskRemoverStop; //actionStop cancels m_diskRemover
         QString m_currentWCpath; //current working copy path
 
         void createMenus();
         void applyConfigurations();
+        void setDiskRemoverStop();
 
         bool isFileListSelected();
         QStringList selectedPaths();
@@ -92,6 +104,7 @@ class QSvn : public QMainWindow, public Ui::QSvn
         void on_actionShowLog_triggered();
         void on_actionMerge_triggered();
         void on_actionEditProperties_triggered();
+        void on_actionBrowseProperties_triggered();
 
         //Query
         void on_actionDiff_triggered();
@@ -104,9 +117,13 @@ class QSvn : public QMainWindow, public Ui::QSvn
 
         void onSelectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
         void directoryChanged(const QString &dir);
+        void onPathsChanged(const QStringList &paths);
+        void onWatcherOverflow(const QStringList &roots);
 
         //QSvnActionHandlers
         void onQSvnClientCheckoutActionFinished(QString path);
+        void onDiskRemoverProgress(int removedEntries);
+        void onDiskRemoverFinished();
 };
 
 #endif
@@ -0,0 +1,269 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "qsvnactions/qsvnactionscheduler.h"
+#include "qsvnactions/qsvnactionscheduler.moc"
+
+#include <QtCore>
+
+
+//make QSvnActionScheduler a singleton
+QSvnActionScheduler* QSvnActionScheduler::m_instance = 0;
+
+QSvnActionScheduler* QSvnActionScheduler::instance()
+{
+    if (m_instance == 0)
+        m_instance = new QSvnActionScheduler;
+    return m_instance;
+}
+
+QSvnActionScheduler::QSvnActionScheduler(QObject *parent)
+        : QObject(parent)
+{
+    m_nextId = 1;
+    m_maxRunning = qMax(QThread::idealThreadCount(), 2);
+    m_maxPerServer = 4;
+    m_maxPerWc = 1;
+}
+
+int QSvnActionScheduler::enqueue(QSvnAction *action, Priority priority,
+                                 const QString &server, const QString &wc,
+                                 WcAccess access, const QList<int> &dependencies)
+{
+    Job job;
+    job.id = m_nextId++;
+    job.action = action;
+    job.priority = priority;
+    job.server = server;
+    job.wc = normalizeWc(wc);
+    job.access = access;
+    foreach (int dependency, dependencies)
+    {
+        //finished jobs are forgotten as soon as nobody waits for them
+        if (isQueued(dependency) || isRunning(dependency) ||
+            m_canceledJobs.contains(dependency))
+            job.dependencies << dependency;
+    }
+
+    int pos = m_queue.count();
+    while (pos > 0 && m_queue.at(pos - 1).priority > priority)
+        pos--;
+    m_queue.insert(pos, job);
+
+    connect(action, SIGNAL(finished()), this, SLOT(onActionFinished()));
+    schedule();
+    return job.id;
+}
+
+bool QSvnActionScheduler::cancel(int job)
+{
+    for (int i = 0; i < m_queue.count(); ++i)
+    {
+        if (m_queue.at(i).id == job)
+        {
+            disconnect(m_queue.at(i).action, SIGNAL(finished()), this, SLOT(onActionFinished()));
+            m_queue.removeAt(i);
+            m_canceledJobs << job;
+            emit canceled(job);
+            //jobs depending on this one will never start
+            schedule();
+            pruneJobs();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool QSvnActionScheduler::isQueued(int job) const
+{
+    foreach (const Job &queued, m_queue)
+    {
+        if (queued.id == job)
+            return true;
+    }
+    return false;
+}
+
+bool QSvnActionScheduler::isRunning(int job) const
+{
+    foreach (const Job &running, m_running)
+    {
+        if (running.id == job)
+            return true;
+    }
+    return false;
+}
+
+bool QSvnActionScheduler::isIdle() const
+{
+    return m_queue.isEmpty() && m_running.isEmpty();
+}
+
+void QSvnActionScheduler::setMaxRunning(int count)
+{
+    m_maxRunning = qMax(count, 1);
+    schedule();
+}
+
+void QSvnActionScheduler::setMaxPerServer(int count)
+{
+    m_maxPerServer = qMax(count, 1);
+    schedule();
+}
+
+void QSvnActionScheduler::setMaxPerWc(int count)
+{
+    m_maxPerWc = qMax(count, 1);
+    schedule();
+}
+
+void QSvnActionScheduler::onActionFinished()
+{
+    QSvnAction *action = static_cast<QSvnAction*>(sender());
+    if (!m_running.contains(action))
+        return;
+
+    Job job = m_running.take(action);
+    disconnect(action, SIGNAL(finished()), this, SLOT(onActionFinished()));
+    m_finishedJobs << job.id;
+    emit finished(job.id);
+    schedule();
+    pruneJobs();
+}
+
+void QSvnActionScheduler::schedule()
+{
+    //writers waiting in front of a job, readers don't overtake them
+    QList<Job> waitingWriters;
+    int i = 0;
+    while (i < m_queue.count() && m_running.count() < m_maxRunning)
+    {
+        Job job = m_queue.at(i);
+
+        bool dependencyCanceled = false;
+        foreach (int dependency, job.dependencies)
+            dependencyCanceled |= m_canceledJobs.contains(dependency);
+        if (dependencyCanceled)
+        {
+            disconnect(job.action, SIGNAL(finished()), this, SLOT(onActionFinished()));
+            m_queue.removeAt(i);
+            m_canceledJobs << job.id;
+            emit canceled(job.id);
+            //restart, the canceled job may block others
+            waitingWriters.clear();
+            i = 0;
+            continue;
+        }
+
+        if (canStart(job, waitingWriters))
+        {
+            m_queue.removeAt(i);
+            m_running.insert(job.action, job);
+            emit started(job.id);
+            job.action->start();
+        }
+        else
+        {
+            if (job.access == Exclusive && !job.wc.isEmpty())
+                waitingWriters << job;
+            i++;
+        }
+    }
+}
+
+void QSvnActionScheduler::pruneJobs()
+{
+    QSet<int> dependencies;
+    foreach (const Job &queued, m_queue)
+        dependencies += QSet<int>::fromList(queued.dependencies);
+    m_finishedJobs.intersect(dependencies);
+    m_canceledJobs.intersect(dependencies);
+}
+
+bool QSvnActionScheduler::canStart(const Job &job, const QList<Job> &waitingWriters) const
+{
+    foreach (int dependency, job.dependencies)
+    {
+        if (!m_finishedJobs.contains(dependency))
+            return false;
+    }
+
+    //keep the last slots free for interactive jobs
+    int reserve = (job.priority == Interactive) ? 0 : 1;
+    if (m_running.count() + reserve >= qMax(m_maxRunning, 1 + reserve))
+        return false;
+
+    int serverCount = 0, wcCount = 0;
+    foreach (const Job &running, m_running)
+    {
+        if (!job.server.isEmpty() && running.server == job.server)
+            serverCount++;
+        if (blocks(running, job))
+            wcCount++;
+    }
+    if (serverCount + reserve >= qMax(m_maxPerServer, 1 + reserve))
+        return false;
+    if (wcCount >= m_maxPerWc)
+        return false;
+
+    if (job.access == Shared)
+    {
+        foreach (const Job &writer, waitingWriters)
+        {
+            if (writer.priority <= job.priority && isSameWc(writer.wc, job.wc))
+                return false;
+        }
+    }
+
+    return true;
+}
+
+bool QSvnActionScheduler::blocks(const Job &running, const Job &job)
+{
+    if (!isSameWc(running.wc, job.wc))
+        return false;
+    if (running.access == Shared && job.access == Shared)
+        return false;
+    //a background reader never holds off interactive work, svn reads without a lock
+    if (running.access == Shared && running.priority != Interactive && job.priority == Interactive)
+        return false;
+    return true;
+}
+
+bool QSvnActionScheduler::isSameWc(const QString &wc1, const QString &wc2)
+{
+    if (wc1.isEmpty() || wc2.isEmpty())
+        return false;
+    return (wc1 == wc2) ||
+            wc1.startsWith(wc2 + "/") ||
+            wc2.startsWith(wc1 + "/");
+}
+
+QString QSvnActionScheduler::normalizeWc(const QString &wc)
+{
+    if (wc.isEmpty())
+        return wc;
+    QString _wc = QDir::cleanPath(QDir::fromNativeSeparators(wc));
+#if defined Q_WS_WIN32
+    _wc = _wc.toLower();
+#endif
+    return _wc;
+}
@@ -0,0 +1,130 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#ifndef QSVNACTIONSCHEDULER_H
+#define QSVNACTIONSCHEDULER_H
+
+#include "qsvnactions/qsvnaction.h"
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+
+/**
+Starts QSvnActions in order of their priority. The number of running actions
+is limited globally, per server and per working copy, so two actions never
+contend for the same working copy lock. Actions which only read a working copy
+share it, an action modifying it runs alone. Background actions never take the
+last free slot and never delay interactive ones.
+*/
+
+class QSvnActionScheduler : public QObject
+{
+    Q_OBJECT
+
+    public:
+        enum Priority
+        {
+            Interactive = 0, //the user waits for it
+            Prefetch    = 1, //results the user will probably look at soon
+            Maintenance = 2  //background refreshes
+        };
+
+        enum WcAccess
+        {
+            Shared    = 0, //reads the working copy, e.g. status, proplist or log
+            Exclusive = 1  //modifies the working copy, e.g. commit, merge, propset or checkout
+        };
+
+        static QSvnActionScheduler *instance();
+
+        /**
+         * Queue an action. The scheduler starts it, but doesn't take the ownership.
+         * @param server Key for the per server limit, the host of the repository.
+         *               Empty for actions which only work on the working copy.
+         * @param wc Working copy the action works on. Nested working copies share one lock.
+         * @param access Whether the action only reads the working copy or modifies it.
+         * @param dependencies Jobs that have to be finished before this one starts.
+         *                     Jobs the scheduler doesn't know anymore count as finished.
+         * @return Id of the job.
+         */
+        int enqueue(QSvnAction *action, Priority priority,
+                    const QString &server = QString(), const QString &wc = QString(),
+                    WcAccess access = Exclusive,
+                    const QList<int> &dependencies = QList<int>());
+        /**
+         * Remove a job from the queue. Running jobs can't be canceled here.
+         * @return true, if the job was queued and is removed now.
+         */
+        bool cancel(int job);
+
+        bool isQueued(int job) const;
+        bool isRunning(int job) const;
+        bool isIdle() const;
+
+        void setMaxRunning(int count);
+        void setMaxPerServer(int count);
+        void setMaxPerWc(int count);
+
+    signals:
+        void started(int job);
+        void finished(int job);
+        void canceled(int job);
+
+    private slots:
+        void onActionFinished();
+
+    private:
+        QSvnActionScheduler(QObject *parent = 0);
+
+        struct Job
+        {
+            int id;
+            QSvnAction *action;
+            Priority priority;
+            QString server;
+            QString wc;
+            WcAccess access;
+            QList<int> dependencies;
+        };
+
+        static QSvnActionScheduler *m_instance;
+
+        int m_nextId;
+        int m_maxRunning;
+        int m_maxPerServer;
+        int m_maxPerWc;
+        QList<Job> m_queue; //sorted by priority, first in first out within a priority
+        QHash<QSvnAction*, Job> m_running;
+        QSet<int> m_finishedJobs; //only those queued jobs still depend on
+        QSet<int> m_canceledJobs; //only those queued jobs still depend on
+
+        void schedule();
+        void pruneJobs();
+        bool canStart(const Job &job, const QList<Job> &waitingWriters) const;
+        static bool blocks(const Job &running, const Job &job);
+        static bool isSameWc(const QString &wc1, const QString &wc2);
+        static QString normalizeWc(const QString &wc);
+};
+
+#endif // QSVNACTIONSCHEDULER_H
@@ -20,8 +20,12 @@
 
 #include "qsvnclientaction.h"
 #include "qsvnclientaction.moc"
+#include "qsvnpromptbroker.h"
+#include "listener.h"
 #include "svnqt/context_listener.hpp"
 
+#include <QDir>
+
 QSvnClientAction::QSvnClientAction(QObject * parent)
         : QSvnAction(parent)
 {
@@ -29,8 +33,10 @@ QSvnClientAction::QSvnClientAction(QObject * parent)
     svnClient = svn::Client::getobject(svnContext, 0);
     svnContext->setListener(this);
     inExternal = false;
-    isActionCanceled = false;
+    isActionCanceled = 0;
     sslServerTrustData = 0;
+    progressBase = 0;
+    progressLast = 0;
 }
 
 QSvnClientAction::~QSvnClientAction()
@@ -45,29 +51,33 @@ bool QSvnClientAction::contextGetLogin(const QString & realm,
                                        QString & password,
                                        bool & maySave)
 {
-    startEmit();
-    emit doGetLogin(realm, username, password, maySave);
-    while (emitIsRunning)
-        sleep(1);
-    if (emitIsAborted)
-        return false;
-    else
+    const QString key = "login:" + realm;
+    QSvnPromptAnswer answer;
+
+    if (QSvnPromptBroker::instance()->acquire(key))
     {
-        username = login_username;
-        password = login_password;
-        maySave = login_maySave;
-        return true;
+        promptKey = key;
+        emit doGetLogin(realm, username, password, maySave);
     }
-}
+    QSvnPromptBroker::Result result = QSvnPromptBroker::instance()->wait(key, answer, isActionCanceled);
 
-void QSvnClientAction::startEmit()
-{
-    emitIsAborted = false;
-    emitIsRunning = true;
+    if (result != QSvnPromptBroker::Answered)
+        return false;
+
+    username = answer.username;
+    password = answer.password;
+    maySave = answer.maySave;
+    return true;
 }
 
 void QSvnClientAction::contextNotify(const svn_wc_notify_t *action)
 {
+    if (action->path && Listener::isWcChange(action->action))
+    {
+        QMutexLocker locker(&touchedMutex);
+        touched.insert(QDir::toNativeSeparators(QDir::cleanPath(action->path)));
+    }
+
     QString actionString;
     switch (action->action)
     {
@@ -245,58 +255,65 @@ void QSvnClientAction::contextNotify(const svn_wc_notify_t *action)
     emit notify(actionString, QString(action->path));
 }
 
+QStringList QSvnClientAction::touchedPaths()
+{
+    QMutexLocker locker(&touchedMutex);
+    return touched.toList();
+}
+
 bool QSvnClientAction::contextCancel()
 {
-    return isActionCanceled;
+    return isActionCanceled != 0;
 }
 
 svn::ContextListener::SslServerTrustAnswer QSvnClientAction::contextSslServerTrustPrompt
         (const SslServerTrustData &data,
          apr_uint32_t &acceptedFailures)
 {
-    startEmit();
-    sslServerTrustData = new svn::ContextListener::SslServerTrustData(data);
-    emit doGetSslServerTrustPrompt();
-    while (emitIsRunning)
-        sleep(1);
-    if (emitIsAborted)
-        return svn::ContextListener::SslServerTrustAnswer();
-    else
+    const QString key = "ssl:" + data.realm + ":" + data.fingerprint;
+    QSvnPromptAnswer answer;
+
+    if (QSvnPromptBroker::instance()->acquire(key))
     {
-        return sslprompt_answer;
+        promptKey = key;
+        if (sslServerTrustData)
+            delete sslServerTrustData;
+        sslServerTrustData = new svn::ContextListener::SslServerTrustData(data);
+        emit doGetSslServerTrustPrompt();
     }
+    QSvnPromptBroker::Result result = QSvnPromptBroker::instance()->wait(key, answer, isActionCanceled);
+
+    if (result != QSvnPromptBroker::Answered)
+        return svn::ContextListener::SslServerTrustAnswer();
+    else
+        return answer.sslServerTrustAnswer;
 }
 
 void QSvnClientAction::cancelAction()
 {
-    isActionCanceled = true;
-    terminate();
+    //svn stops at its next call of contextCancel() and releases the working copy locks
+    isActionCanceled = 1;
 }
 
 void QSvnClientAction::endGetLogin(QString username, QString password, bool maySave)
 {
-    login_username = username;
-    login_password = password;
-    login_maySave = maySave;
-    finishEmit();
-}
-
-void QSvnClientAction::finishEmit()
-{
-    emitIsAborted = false;
-    emitIsRunning = false;
+    QSvnPromptAnswer answer;
+    answer.username = username;
+    answer.password = password;
+    answer.maySave = maySave;
+    QSvnPromptBroker::instance()->answer(promptKey, answer);
 }
 
 void QSvnClientAction::endGetSslServerTrustPrompt(SslServerTrustAnswer answer)
 {
-    sslprompt_answer = answer;
-    finishEmit();
+    QSvnPromptAnswer promptAnswer;
+    promptAnswer.sslServerTrustAnswer = answer;
+    QSvnPromptBroker::instance()->answer(promptKey, promptAnswer);
 }
 
 void QSvnClientAction::abortEmit()
 {
-    emitIsAborted = true;
-    emitIsRunning = false;
+    QSvnPromptBroker::instance()->abort(promptKey);
 }
 
 svn::ContextListener::SslServerTrustData QSvnClientAction::getSslServerTrustData()
@@ -307,3 +324,17 @@ svn::ContextListener::SslServerTrustData QSvnClientAction::getSslServerTrustData
         return 0;
 }
 
+void QSvnClientAction::contextProgress(long long int current, long long int max)
+{
+    QMutexLocker locker(&progressMutex);
+    //every ra session starts counting from zero again
+    if (current < progressLast)
+        progressBase += progressLast;
+    progressLast = current;
+}
+
+qlonglong QSvnClientAction::transferredBytes()
+{
+    QMutexLocker locker(&progressMutex);
+    return progressBase + progressLast;
+}
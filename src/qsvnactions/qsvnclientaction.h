@@ -26,6 +26,11 @@
 #include "svnqt/client.hpp"
 #include "svnqt/context_listener.hpp"
 
+#include <QAtomicInt>
+#include <QMutex>
+#include <QSet>
+#include <QStringList>
+
 
 class QSvnClientAction : public QSvnAction, public svn::ContextListener
 {
@@ -59,9 +64,11 @@ class QSvnClientAction : public QSvnAction, public svn::ContextListener
         virtual bool contextLoadSslClientCertPw(QString&, const QString&) { return false; };
         virtual bool contextGetSavedLogin(const QString&, QString&, QString&) { return false; };
         virtual bool contextGetCachedLogin(const QString & realm, QString & username, QString & password) { return false; };
-        virtual void contextProgress(long long int current, long long int max) {};
+        virtual void contextProgress(long long int current, long long int max);
 
         SslServerTrustData getSslServerTrustData();
+        qlonglong transferredBytes(); //bytes transferred over the network so far
+        QStringList touchedPaths(); //paths changed in the working copy so far
 
     protected:
         svn::ContextP svnContext;
@@ -69,20 +76,18 @@ class QSvnClientAction : public QSvnAction, public svn::ContextListener
 
     private:
         bool inExternal;
-        bool isActionCanceled;
-        bool emitIsRunning;
-        bool emitIsAborted;
-        //variables for login
-        QString login_realm;
-        QString login_username;
-        QString login_password;
-        bool login_maySave;
+        QAtomicInt isActionCanceled;
+        //key of the prompt raised by this action in QSvnPromptBroker
+        QString promptKey;
         //variables for SslServerTrustPrompt
         SslServerTrustData *sslServerTrustData;
-        SslServerTrustAnswer sslprompt_answer;
-
-        void startEmit();
-        void finishEmit();
+        //variables for progress
+        QMutex progressMutex;
+        qlonglong progressBase;
+        qlonglong progressLast;
+        //paths from the notifications
+        QMutex touchedMutex;
+        QSet<QString> touched;
 
     public slots:
         void cancelAction();
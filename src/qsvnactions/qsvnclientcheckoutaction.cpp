@@ -21,22 +21,26 @@
 #include "qsvnactions/qsvnclientcheckoutaction.h"
 #include "qsvnactions/qsvnclientcheckoutaction.moc"
 
-QSvnClientCheckoutAction::QSvnClientCheckoutAction(const QString url, const QString path)
+QSvnClientCheckoutAction::QSvnClientCheckoutAction(const QString url, const QString path,
+                                                   const svn::Revision revision, svn::Depth depth)
         : QSvnClientAction()
 {
     checkoutParameter
             .moduleName(url)
             .destination(path)
-            .revision(svn::Revision::HEAD);
+            .revision(revision)
+            .depth(depth);
 }
 
-QSvnClientCheckoutAction::QSvnClientCheckoutAction(QObject * parent, const QString url, const QString path)
+QSvnClientCheckoutAction::QSvnClientCheckoutAction(QObject * parent, const QString url, const QString path,
+                                                   const svn::Revision revision, svn::Depth depth)
         : QSvnClientAction(parent)
 {
     checkoutParameter
             .moduleName(url)
             .destination(path)
-            .revision(svn::Revision::HEAD);
+            .revision(revision)
+            .depth(depth);
 }
 
 void QSvnClientCheckoutAction::run()
@@ -30,8 +30,12 @@ class QSvnClientCheckoutAction : public QSvnClientAction
     Q_OBJECT
 
     public:
-        QSvnClientCheckoutAction(const QString url, const QString path);
-        QSvnClientCheckoutAction(QObject * parent, const QString url, const QString path);
+        QSvnClientCheckoutAction(const QString url, const QString path,
+                                 const svn::Revision revision = svn::Revision::HEAD,
+                                 svn::Depth depth = svn::DepthInfinity);
+        QSvnClientCheckoutAction(QObject * parent, const QString url, const QString path,
+                                 const svn::Revision revision = svn::Revision::HEAD,
+                                 svn::Depth depth = svn::DepthInfinity);
 
     protected:
         void run();
@@ -0,0 +1,102 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnclientcommitaction.h"
+#include "qsvnactions/qsvnclientcommitaction.moc"
+
+#include "svnqt/status.hpp"
+#include "svnqt/targets.hpp"
+
+#include <QFileInfo>
+
+QSvnClientCommitAction::QSvnClientCommitAction(const QStringList paths, const QString logMessage,
+                                               svn::Depth depth)
+        : QSvnClientAction()
+{
+    commitPaths = paths;
+    commitDepth = depth;
+    commitParameter
+            .targets(svn::Targets(paths))
+            .message(logMessage);
+    transmitted = 0;
+}
+
+QSvnClientCommitAction::QSvnClientCommitAction(QObject * parent, const QStringList paths, const QString logMessage,
+                                               svn::Depth depth)
+        : QSvnClientAction(parent)
+{
+    commitPaths = paths;
+    commitDepth = depth;
+    commitParameter
+            .targets(svn::Targets(paths))
+            .message(logMessage);
+    transmitted = 0;
+}
+
+void QSvnClientCommitAction::contextNotify(const svn_wc_notify_t *action)
+{
+    QSvnClientAction::contextNotify(action);
+
+    if (action->action == svn_wc_notify_commit_postfix_txdelta)
+    {
+        transmitted.ref();
+        emit fileTransmitted(QString(action->path));
+    }
+}
+
+int QSvnClientCommitAction::transmittedFiles()
+{
+    return transmitted;
+}
+
+void QSvnClientCommitAction::run()
+{
+    if (commitPaths.isEmpty())
+    {
+        emit finished(QString());
+        return;
+    }
+
+    try
+    {
+        //deleted directories need DepthInfinity
+        if (commitDepth == svn::DepthUnknown)
+        {
+            commitDepth = svn::DepthFiles;
+            foreach (QString path, commitPaths)
+            {
+                if (QFileInfo(path).isDir() &&
+                    svnClient->singleStatus(path, false, svn::Revision::HEAD)->textStatus() == svn_wc_status_deleted)
+                {
+                    commitDepth = svn::DepthInfinity;
+                    break;
+                }
+            }
+        }
+        commitParameter.depth(commitDepth);
+        svnClient->commit(commitParameter);
+    }
+    catch (svn::ClientException e)
+    {
+        emit notify(tr("Error"), e.msg());
+        return;
+    }
+    emit finished(commitPaths.at(0));
+}
@@ -0,0 +1,64 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#ifndef QSVNCLIENTCOMMITACTION_H
+#define QSVNCLIENTCOMMITACTION_H
+
+#include "qsvnactions/qsvnclientaction.h"
+#include "svnqt/client_parameter.hpp"
+
+#include <QStringList>
+
+
+/**
+Commits a list of paths. fileTransmitted() is emitted for every file
+whose content is sent to the repository. With svn::DepthUnknown, the
+depth is chosen in the thread: DepthInfinity if a directory of the list
+is deleted, DepthFiles otherwise.
+*/
+class QSvnClientCommitAction : public QSvnClientAction
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientCommitAction(const QStringList paths, const QString logMessage,
+                               svn::Depth depth = svn::DepthUnknown);
+        QSvnClientCommitAction(QObject * parent, const QStringList paths, const QString logMessage,
+                               svn::Depth depth = svn::DepthUnknown);
+
+        virtual void contextNotify(const svn_wc_notify_t *action);
+
+        int transmittedFiles(); //files sent so far
+
+    signals:
+        void fileTransmitted(QString path);
+
+    protected:
+        void run();
+
+    private:
+        QStringList commitPaths;
+        svn::Depth commitDepth;
+        svn::CommitParameter commitParameter;
+        QAtomicInt transmitted;
+};
+
+#endif // QSVNCLIENTCOMMITACTION_H
@@ -0,0 +1,83 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnclientlogaction.h"
+#include "qsvnactions/qsvnclientlogaction.moc"
+
+#include "svnqt/client_parameter.hpp"
+
+QSvnClientLogAction::QSvnClientLogAction(QObject * parent, const QString url, svn_revnum_t startRevision,
+                                         bool discoverChangedPaths, int limit)
+        : QSvnClientAction(parent)
+{
+    logUrl = url;
+    logStartRevision = startRevision;
+    logDiscoverChangedPaths = discoverChangedPaths;
+    logLimit = limit;
+    head = -1;
+}
+
+QString QSvnClientLogAction::url() const
+{
+    return logUrl;
+}
+
+svn_revnum_t QSvnClientLogAction::headRevision() const
+{
+    return head;
+}
+
+svn::LogEntriesMap QSvnClientLogAction::logEntries() const
+{
+    return entries;
+}
+
+void QSvnClientLogAction::run()
+{
+    try
+    {
+        svn::InfoEntries infoEntries = svnClient->info(logUrl, svn::DepthEmpty,
+                                                       svn::Revision::HEAD, svn::Revision::HEAD);
+        if (infoEntries.isEmpty())
+            return;
+        head = infoEntries.at(0).revision();
+
+        if (contextCancel())
+            return;
+
+        if (logStartRevision <= head)
+        {
+            svn::LogParameter params;
+            svnClient->log(params.targets(logUrl)
+                           .revisionRange(svn::Revision(logStartRevision), svn::Revision(head))
+                           .peg(svn::Revision::HEAD)
+                           .discoverChangedPathes(logDiscoverChangedPaths)
+                           .strictNodeHistory(true)
+                           .limit(logLimit),
+                           entries);
+        }
+    }
+    catch (svn::ClientException e)
+    {
+        emit notify(tr("Error"), e.msg());
+        return;
+    }
+    emit finished(logUrl);
+}
@@ -0,0 +1,61 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef QSVNCLIENTLOGACTION_H
+#define QSVNCLIENTLOGACTION_H
+
+#include "qsvnactions/qsvnclientaction.h"
+
+
+/**
+Reads the head revision of an url and its log from startRevision up to
+the head. Only the history of the path itself is followed, the log stops
+at the revision the path was copied in.
+*/
+class QSvnClientLogAction : public QSvnClientAction
+{
+    Q_OBJECT
+
+    public:
+        /**
+         * @param startRevision First revision to read. If it is newer than the head,
+         *                      only the head revision is read.
+         * @param limit Maximum number of log entries, 0 for all.
+         */
+        QSvnClientLogAction(QObject * parent, const QString url, svn_revnum_t startRevision = 0,
+                            bool discoverChangedPaths = false, int limit = 0);
+
+        QString url() const;
+        svn_revnum_t headRevision() const; //-1 until it is read
+        svn::LogEntriesMap logEntries() const; //complete after finished(QString)
+
+    protected:
+        void run();
+
+    private:
+        QString logUrl;
+        svn_revnum_t logStartRevision;
+        bool logDiscoverChangedPaths;
+        int logLimit;
+        svn_revnum_t head;
+        svn::LogEntriesMap entries;
+};
+
+#endif // QSVNCLIENTLOGACTION_H
@@ -0,0 +1,142 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnclientmergeaction.h"
+#include "qsvnactions/qsvnclientmergeaction.moc"
+
+#include <QDir>
+
+#include <svn_version.h>
+
+QSvnClientMergeAction::QSvnClientMergeAction(QObject * parent,
+                                             const QString fromUrl, const svn::Revision fromRevision,
+                                             const QString toUrl, const svn::Revision toRevision,
+                                             const QString wcPath, bool dryRun)
+        : QSvnClientAction(parent)
+{
+    mergeWcPath = wcPath;
+    mergeDryRun = dryRun;
+    mergePeg = false;
+
+    svn::RevisionRanges revisionRanges;
+    revisionRanges.append(svn::RevisionRange(fromRevision, toRevision));
+    mergeParameter
+            .revisions(revisionRanges)
+            .path1(fromUrl)
+            .path2(toUrl)
+            .localPath(wcPath)
+            .depth(svn::DepthInfinity)
+            .notice_ancestry(false)
+            .force(true)
+            .dry_run(dryRun);
+}
+
+QSvnClientMergeAction::QSvnClientMergeAction(QObject * parent,
+                                             const QString url, const svn::RevisionRanges &revisionRanges,
+                                             const QString wcPath, bool dryRun)
+        : QSvnClientAction(parent)
+{
+    mergeWcPath = wcPath;
+    mergeDryRun = dryRun;
+    mergePeg = true;
+
+    mergeParameter
+            .revisions(revisionRanges)
+            .path1(url)
+            .peg(svn::Revision::HEAD)
+            .localPath(wcPath)
+            .depth(svn::DepthInfinity)
+            .notice_ancestry(false)
+            .force(true)
+            .dry_run(dryRun);
+}
+
+void QSvnClientMergeAction::contextNotify(const svn_wc_notify_t *action)
+{
+    QSvnClientAction::contextNotify(action);
+
+    Entry entry;
+    entry.action = action->action;
+    entry.kind = action->kind;
+    entry.contentState = action->content_state;
+    entry.propState = action->prop_state;
+    entry.treeConflict = false;
+    switch (action->action)
+    {
+        case svn_wc_notify_merge_begin:
+        case svn_wc_notify_foreign_merge_begin:
+            return;
+#if SVN_VER_MAJOR == 1 && SVN_VER_MINOR >= 6
+        case svn_wc_notify_tree_conflict:
+            entry.treeConflict = true;
+            break;
+#endif
+        default:
+            break;
+    }
+    if (!action->path)
+        return;
+    entry.path = QDir::toNativeSeparators(QDir::cleanPath(action->path));
+
+    QMutexLocker locker(&entriesMutex);
+    entries << entry;
+}
+
+QString QSvnClientMergeAction::wcPath() const
+{
+    return mergeWcPath;
+}
+
+bool QSvnClientMergeAction::isDryRun() const
+{
+    return mergeDryRun;
+}
+
+QSvnClientMergeAction::Entries QSvnClientMergeAction::takeEntries()
+{
+    QMutexLocker locker(&entriesMutex);
+    Entries result = entries;
+    entries.clear();
+    return result;
+}
+
+bool QSvnClientMergeAction::isConflict(const Entry &entry)
+{
+    return entry.treeConflict ||
+            entry.contentState == svn_wc_notify_state_conflicted ||
+            entry.propState == svn_wc_notify_state_conflicted;
+}
+
+void QSvnClientMergeAction::run()
+{
+    try
+    {
+        if (mergePeg)
+            svnClient->merge_peg(mergeParameter);
+        else
+            svnClient->merge(mergeParameter);
+    }
+    catch (svn::ClientException e)
+    {
+        emit notify(tr("Error"), e.msg());
+        return;
+    }
+    emit finished(mergeWcPath);
+}
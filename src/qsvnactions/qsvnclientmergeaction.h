@@ -0,0 +1,83 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef QSVNCLIENTMERGEACTION_H
+#define QSVNCLIENTMERGEACTION_H
+
+#include "qsvnactions/qsvnclientaction.h"
+#include "svnqt/client_parameter.hpp"
+
+#include <QList>
+#include <QMutex>
+
+
+/**
+Merges the differences between two sources into a working copy. Every
+notification is kept as an Entry, so a dry run gives the complete result
+without touching the working copy.
+*/
+class QSvnClientMergeAction : public QSvnClientAction
+{
+    Q_OBJECT
+
+    public:
+        struct Entry
+        {
+            QString path;
+            svn_wc_notify_action_t action;
+            svn_node_kind_t kind;
+            svn_wc_notify_state_t contentState;
+            svn_wc_notify_state_t propState;
+            bool treeConflict;
+        };
+        typedef QList<Entry> Entries;
+
+        QSvnClientMergeAction(QObject * parent,
+                              const QString fromUrl, const svn::Revision fromRevision,
+                              const QString toUrl, const svn::Revision toRevision,
+                              const QString wcPath, bool dryRun);
+        /**
+         * Merge several revision ranges of url in one pass.
+         */
+        QSvnClientMergeAction(QObject * parent,
+                              const QString url, const svn::RevisionRanges &revisionRanges,
+                              const QString wcPath, bool dryRun);
+
+        virtual void contextNotify(const svn_wc_notify_t *action);
+
+        QString wcPath() const;
+        bool isDryRun() const;
+        Entries takeEntries(); //entries since the last call
+
+        static bool isConflict(const Entry &entry);
+
+    protected:
+        void run();
+
+    private:
+        QString mergeWcPath;
+        bool mergeDryRun;
+        bool mergePeg;
+        svn::MergeParameter mergeParameter;
+        QMutex entriesMutex;
+        Entries entries;
+};
+
+#endif // QSVNCLIENTMERGEACTION_H
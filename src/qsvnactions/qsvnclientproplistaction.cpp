@@ -0,0 +1,103 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnclientproplistaction.h"
+#include "qsvnactions/qsvnclientproplistaction.moc"
+
+#include "svnqt/wc.hpp"
+
+#include <QDir>
+#include <QQueue>
+
+QSvnClientPropListAction::QSvnClientPropListAction(QObject * parent, const QString path,
+                                                   svn::Depth depth)
+        : QSvnClientAction(parent)
+{
+    listPath = QDir::toNativeSeparators(QDir::cleanPath(path));
+    listDepth = depth;
+}
+
+QString QSvnClientPropListAction::path() const
+{
+    return listPath;
+}
+
+svn::PathPropertiesMapList QSvnClientPropListAction::takeEntries()
+{
+    QMutexLocker locker(&entriesMutex);
+    svn::PathPropertiesMapList result = entries;
+    entries.clear();
+    return result;
+}
+
+bool QSvnClientPropListAction::readProperties(const QString &path, svn::Depth depth)
+{
+    svn::PathPropertiesMapListPtr list;
+    try
+    {
+        list = svnClient->proplist(path, svn::Revision::WORKING, svn::Revision::WORKING, depth);
+    }
+    catch (svn::ClientException e)
+    {
+        emit notify(tr("Error"), e.msg());
+        return false;
+    }
+
+    if (list && !list->isEmpty())
+    {
+        QMutexLocker locker(&entriesMutex);
+        entries << *list;
+    }
+    emit entriesRead();
+    return true;
+}
+
+void QSvnClientPropListAction::run()
+{
+    if (listDepth != svn::DepthInfinity || !QFileInfo(listPath).isDir())
+    {
+        if (readProperties(listPath, listDepth))
+            emit finished(listPath);
+        return;
+    }
+
+    //svnqt returns the whole list at once, so the tree is read by directories to show the first entries early
+    QQueue<QString> directories;
+    directories.enqueue(listPath);
+    while (!directories.isEmpty())
+    {
+        if (contextCancel())
+            return;
+
+        QString directory = directories.dequeue();
+        if (!readProperties(directory, svn::DepthFiles))
+            return;
+
+        foreach (QString name, QDir(directory).entryList(QDir::AllDirs | QDir::NoDotAndDotDot | QDir::Hidden))
+        {
+            if (name == ".svn" || name == "_svn")
+                continue;
+            QString subdirectory = directory + QDir::separator() + name;
+            if (svn::Wc::checkWc(subdirectory))
+                directories.enqueue(subdirectory);
+        }
+    }
+    emit finished(listPath);
+}
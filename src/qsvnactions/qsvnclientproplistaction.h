@@ -0,0 +1,62 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#ifndef QSVNCLIENTPROPLISTACTION_H
+#define QSVNCLIENTPROPLISTACTION_H
+
+#include "qsvnactions/qsvnclientaction.h"
+#include "svnqt/svnqttypes.hpp"
+
+#include <QMutex>
+
+
+/**
+Reads the properties of a path and, with DepthInfinity, of all versioned
+paths below. The tree is read one directory after another, entriesRead()
+is emitted after every directory and takeEntries() hands over the new entries.
+*/
+class QSvnClientPropListAction : public QSvnClientAction
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientPropListAction(QObject * parent, const QString path,
+                                 svn::Depth depth = svn::DepthInfinity);
+
+        QString path() const;
+        svn::PathPropertiesMapList takeEntries(); //entries read since the last call
+
+    signals:
+        void entriesRead();
+
+    protected:
+        void run();
+
+    private:
+        QString listPath;
+        svn::Depth listDepth;
+        QMutex entriesMutex;
+        svn::PathPropertiesMapList entries;
+
+        bool readProperties(const QString &path, svn::Depth depth);
+};
+
+#endif // QSVNCLIENTPROPLISTACTION_H
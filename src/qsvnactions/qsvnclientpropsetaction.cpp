@@ -0,0 +1,70 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnclientpropsetaction.h"
+#include "qsvnactions/qsvnclientpropsetaction.moc"
+
+#include "svnqt/client_parameter.hpp"
+
+QSvnClientPropSetAction::QSvnClientPropSetAction(QObject * parent, const Changes &changes)
+        : QSvnClientAction(parent)
+{
+    this->changes = changes;
+}
+
+QSvnClientPropSetAction::Changes QSvnClientPropSetAction::appliedChanges()
+{
+    QMutexLocker locker(&appliedMutex);
+    return applied;
+}
+
+void QSvnClientPropSetAction::run()
+{
+    bool hasError = false;
+    foreach (Change change, changes)
+    {
+        if (contextCancel())
+            return;
+
+        //an empty value deletes a property
+        svn::PropertiesParameter params;
+        params
+                .propertyName(change.name)
+                .propertyValue(change.remove ? QString() : change.value)
+                .path(svn::Path(change.path))
+                .depth(svn::DepthEmpty)
+                .revision(svn::Revision::WORKING);
+        try
+        {
+            svnClient->propset(params);
+        }
+        catch (svn::ClientException e)
+        {
+            emit notify(tr("Error"), e.msg());
+            hasError = true;
+            continue;
+        }
+
+        QMutexLocker locker(&appliedMutex);
+        applied << change;
+    }
+    if (!hasError)
+        emit finished(changes.isEmpty() ? QString() : changes.first().path);
+}
@@ -0,0 +1,61 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#ifndef QSVNCLIENTPROPSETACTION_H
+#define QSVNCLIENTPROPSETACTION_H
+
+#include "qsvnactions/qsvnclientaction.h"
+
+#include <QList>
+#include <QMutex>
+
+
+/**
+Sets or deletes properties on many paths as one job.
+*/
+class QSvnClientPropSetAction : public QSvnClientAction
+{
+    Q_OBJECT
+
+    public:
+        struct Change
+        {
+            QString path;
+            QString name;
+            QString value;
+            bool remove;
+        };
+        typedef QList<Change> Changes;
+
+        QSvnClientPropSetAction(QObject * parent, const Changes &changes);
+
+        Changes appliedChanges(); //changes written without an error
+
+    protected:
+        void run();
+
+    private:
+        Changes changes;
+        QMutex appliedMutex;
+        Changes applied;
+};
+
+#endif // QSVNCLIENTPROPSETACTION_H
@@ -0,0 +1,113 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnclientstatusaction.h"
+#include "qsvnactions/qsvnclientstatusaction.moc"
+
+#include <QFileInfo>
+
+QSvnClientStatusAction::QSvnClientStatusAction(const QString path, svn::Depth depth,
+                                               const bool get_all)
+        : QSvnClientAction()
+{
+    statusPaths << path;
+    statusDepth = depth;
+    statusAll = get_all;
+    readFileInfos = false;
+}
+
+QSvnClientStatusAction::QSvnClientStatusAction(QObject * parent, const QString path, svn::Depth depth,
+                                               const bool get_all)
+        : QSvnClientAction(parent)
+{
+    statusPaths << path;
+    statusDepth = depth;
+    statusAll = get_all;
+    readFileInfos = false;
+}
+
+QSvnClientStatusAction::QSvnClientStatusAction(QObject * parent, const QStringList paths, svn::Depth depth,
+                                               const bool get_all)
+        : QSvnClientAction(parent)
+{
+    statusPaths = paths;
+    statusDepth = depth;
+    statusAll = get_all;
+    readFileInfos = false;
+}
+
+QString QSvnClientStatusAction::path() const
+{
+    return statusPaths.isEmpty() ? QString() : statusPaths.first();
+}
+
+svn::StatusEntries QSvnClientStatusAction::statusEntries() const
+{
+    return entries;
+}
+
+void QSvnClientStatusAction::setReadFileInfos(bool read)
+{
+    readFileInfos = read;
+}
+
+QHash<QString, QSvnClientStatusAction::FileInfo> QSvnClientStatusAction::fileInfos() const
+{
+    return infos;
+}
+
+void QSvnClientStatusAction::run()
+{
+    bool hasError = false;
+    foreach (QString statusPath, statusPaths)
+    {
+        svn::StatusParameter statusParameter(statusPath);
+        statusParameter
+                .depth(statusDepth)
+                .all(statusAll)
+                .update(false)
+                .noIgnore(false)
+                .revision(svn::Revision::WORKING)
+                .ignoreExternals(true);
+        try
+        {
+            entries << svnClient->status(statusParameter);
+        }
+        catch (svn::ClientException e)
+        {
+            emit notify(tr("Error"), e.msg());
+            hasError = true;
+        }
+    }
+
+    if (readFileInfos)
+    {
+        foreach (svn::StatusPtr status, entries)
+        {
+            QFileInfo fileInfo(status->path());
+            FileInfo info;
+            info.isDir = fileInfo.isDir();
+            info.size = fileInfo.size();
+            infos.insert(status->path(), info);
+        }
+    }
+    if (!hasError)
+        emit finished(path());
+}
@@ -0,0 +1,80 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef QSVNCLIENTSTATUSACTION_H
+#define QSVNCLIENTSTATUSACTION_H
+
+#include "qsvnactions/qsvnclientaction.h"
+#include "svnqt/client_parameter.hpp"
+#include "svnqt/status.hpp"
+
+#include <QHash>
+
+
+/**
+Reads the status of one or more paths. By default only interesting entries
+are collected, like modified, conflicted or unversioned ones.
+*/
+class QSvnClientStatusAction : public QSvnClientAction
+{
+    Q_OBJECT
+
+    public:
+        //file system values of an entry
+        struct FileInfo
+        {
+            FileInfo() : isDir(false), size(0) {}
+            bool isDir;
+            qint64 size;
+        };
+
+        QSvnClientStatusAction(const QString path, svn::Depth depth = svn::DepthInfinity,
+                               const bool get_all = false);
+        QSvnClientStatusAction(QObject * parent, const QString path, svn::Depth depth = svn::DepthInfinity,
+                               const bool get_all = false);
+        /**
+         * Read the status of all paths one after another.
+         * finished(QString) is emitted with the first path.
+         */
+        QSvnClientStatusAction(QObject * parent, const QStringList paths, svn::Depth depth,
+                               const bool get_all = false);
+
+        QString path() const;
+        svn::StatusEntries statusEntries() const;
+        /**
+         * Stat every entry in the worker thread too, before finished() is emitted.
+         */
+        void setReadFileInfos(bool read);
+        QHash<QString, FileInfo> fileInfos() const; //by the path of the entry
+
+
+    protected:
+        void run();
+
+    private:
+        QStringList statusPaths;
+        svn::Depth statusDepth;
+        bool statusAll;
+        bool readFileInfos;
+        svn::StatusEntries entries;
+        QHash<QString, FileInfo> infos;
+};
+
+#endif // QSVNCLIENTSTATUSACTION_H
@@ -0,0 +1,135 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "qsvnpromptbroker.h"
+
+#include <QTime>
+
+//interval to check for canceled actions while waiting
+#define PROMPT_POLLINTERVAL 100
+
+
+//make QSvnPromptBroker a singleton
+QSvnPromptBroker* QSvnPromptBroker::m_instance = 0;
+//prompts are raised from several worker threads
+static QMutex instanceMutex;
+
+QSvnPromptBroker* QSvnPromptBroker::instance()
+{
+    QMutexLocker locker(&instanceMutex);
+    if (m_instance == 0)
+        m_instance = new QSvnPromptBroker;
+    return m_instance;
+}
+
+QSvnPromptBroker::QSvnPromptBroker()
+{
+}
+
+bool QSvnPromptBroker::acquire(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    Prompt *prompt = m_prompts.value(key);
+    if (prompt)
+    {
+        prompt->waiters++;
+        m_waiters.insert(QThread::currentThread(), prompt);
+        return false;
+    }
+
+    prompt = new Prompt;
+    prompt->done = false;
+    prompt->aborted = false;
+    prompt->waiters = 1;
+    m_prompts.insert(key, prompt);
+    m_waiters.insert(QThread::currentThread(), prompt);
+    return true;
+}
+
+QSvnPromptBroker::Result QSvnPromptBroker::wait(const QString &key, QSvnPromptAnswer &answer,
+                                                const QAtomicInt &canceled, int timeout)
+{
+    QMutexLocker locker(&m_mutex);
+    //an answered prompt is already gone from m_prompts
+    Prompt *prompt = m_waiters.take(QThread::currentThread());
+    if (!prompt)
+        return Aborted;
+
+    Result result = TimedOut;
+    QTime time;
+    time.start();
+    while (!prompt->done)
+    {
+        if (canceled)
+        {
+            result = Canceled;
+            break;
+        }
+        if (time.elapsed() >= timeout)
+            break;
+        prompt->condition.wait(&m_mutex, PROMPT_POLLINTERVAL);
+    }
+
+    if (prompt->done)
+    {
+        result = prompt->aborted ? Aborted : Answered;
+        answer = prompt->answer;
+    }
+
+    if (--prompt->waiters == 0)
+    {
+        if (m_prompts.value(key) == prompt)
+            m_prompts.remove(key);
+        delete prompt;
+    }
+    return result;
+}
+
+void QSvnPromptBroker::answer(const QString &key, const QSvnPromptAnswer &answer)
+{
+    finish(key, answer, false);
+}
+
+void QSvnPromptBroker::abort(const QString &key)
+{
+    finish(key, QSvnPromptAnswer(), true);
+}
+
+void QSvnPromptBroker::finish(const QString &key, const QSvnPromptAnswer &answer, bool aborted)
+{
+    QMutexLocker locker(&m_mutex);
+    //the remaining waiters keep their pointer, a new acquire raises a new prompt
+    Prompt *prompt = m_prompts.take(key);
+    if (!prompt)
+        return;
+
+    prompt->answer = answer;
+    prompt->aborted = aborted;
+    prompt->done = true;
+    prompt->condition.wakeAll();
+}
+
+int QSvnPromptBroker::waiters(const QString &key)
+{
+    QMutexLocker locker(&m_mutex);
+    Prompt *prompt = m_prompts.value(key);
+    return prompt ? prompt->waiters : 0;
+}
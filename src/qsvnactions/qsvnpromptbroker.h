@@ -0,0 +1,106 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#ifndef QSVNPROMPTBROKER_H
+#define QSVNPROMPTBROKER_H
+
+#include "svnqt/context_listener.hpp"
+
+#include <QAtomicInt>
+#include <QHash>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+//timeout for an unanswered prompt in milliseconds
+#define PROMPT_TIMEOUT 300000
+
+
+struct QSvnPromptAnswer
+{
+    QSvnPromptAnswer() : maySave(false) {}
+
+    QString username;
+    QString password;
+    bool maySave;
+    svn::ContextListener::SslServerTrustAnswer sslServerTrustAnswer;
+};
+
+/**
+Passes login and ssl trust prompts from worker threads to the gui thread.
+Workers block on a wait condition until the prompt is answered. Prompts are
+shared by a key (e.g. the realm), so parallel workers against the same server
+raise only one dialog and all get the same answer. An answered prompt is never
+joined again, a retry after a wrong password raises a new dialog.
+*/
+
+class QSvnPromptBroker
+{
+    public:
+        enum Result
+        {
+            Answered,
+            Aborted,
+            Canceled,
+            TimedOut
+        };
+
+        static QSvnPromptBroker *instance();
+
+        /**
+         * Register the calling thread as waiter for the open prompt with the given key.
+         * @return true, if the caller is the first waiter and has to raise the prompt.
+         */
+        bool acquire(const QString &key);
+        /**
+         * Block until the prompt is answered or aborted, canceled becomes true
+         * or timeout (milliseconds) expires. Every acquire needs exactly one wait
+         * in the same thread.
+         */
+        Result wait(const QString &key, QSvnPromptAnswer &answer,
+                    const QAtomicInt &canceled, int timeout = PROMPT_TIMEOUT);
+
+        void answer(const QString &key, const QSvnPromptAnswer &answer);
+        void abort(const QString &key);
+
+        int waiters(const QString &key);
+
+    private:
+        QSvnPromptBroker();
+
+        struct Prompt
+        {
+            QWaitCondition condition;
+            bool done;
+            bool aborted;
+            int waiters;
+            QSvnPromptAnswer answer;
+        };
+
+        static QSvnPromptBroker *m_instance;
+        QMutex m_mutex;
+        QHash<QString, Prompt*> m_prompts; //open prompts only
+        QHash<QThread*, Prompt*> m_waiters; //prompt of every waiting thread
+
+        void finish(const QString &key, const QSvnPromptAnswer &answer, bool aborted);
+};
+
+#endif // QSVNPROMPTBROKER_H
@@ -0,0 +1,200 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "diskremover.h"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+
+//levels of the nested tree, each level keeps a directory open while it is removed
+#define NESTED_LEVELS 300
+
+
+class DiskRemoverTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        DiskRemoverTests();
+
+    private:
+        QString m_treePath;
+        QString m_outsidePath;
+
+        void createFile(const QString &fileName);
+        int createTree(const QString &path, int directories, int files);
+
+    private slots:
+        void cleanup();
+
+        void testRemoveTree();
+        void testReadOnlyFiles();
+        void testSymLinkIsNotFollowed();
+        void testDeepNesting();
+        void testMoveToTrash();
+        void testCancel();
+};
+
+DiskRemoverTests::DiskRemoverTests()
+{
+    m_treePath = QDir::tempPath() + "/qsvndiskremovertree";
+    m_outsidePath = QDir::tempPath() + "/qsvndiskremoveroutside";
+}
+
+void DiskRemoverTests::createFile(const QString &fileName)
+{
+    QFile file(fileName);
+    file.open(QIODevice::WriteOnly);
+    file.write("qsvn");
+    file.close();
+}
+
+int DiskRemoverTests::createTree(const QString &path, int directories, int files)
+{
+    int entries = 1;
+    QDir().mkpath(path);
+    for (int i = 0; i < directories; ++i)
+    {
+        QString directory = QString("%1/dir%2").arg(path).arg(i);
+        QDir().mkpath(directory);
+        entries++;
+        for (int j = 0; j < files; ++j)
+        {
+            createFile(QString("%1/file%2").arg(directory).arg(j));
+            entries++;
+        }
+    }
+    return entries;
+}
+
+void DiskRemoverTests::cleanup()
+{
+    DiskRemover::removeFromDisk(m_treePath);
+    DiskRemover::removeFromDisk(m_outsidePath);
+    foreach (QString trash, QDir(QDir::tempPath()).entryList(QStringList(".qsvndiskremovertree.qsvn-trash-*"),
+                                                             QDir::Dirs | QDir::Hidden))
+        DiskRemover::removeFromDisk(QDir::tempPath() + "/" + trash);
+}
+
+void DiskRemoverTests::testRemoveTree()
+{
+    int entries = createTree(m_treePath, 10, 10);
+    DiskRemover remover(this, QStringList(m_treePath));
+    remover.start();
+    QVERIFY2(remover.wait(30000), "The remover doesn't finish.");
+
+    QVERIFY2(!QFileInfo(m_treePath).exists(), "The tree is still on the disk.");
+    QVERIFY2(remover.failedPaths().isEmpty(), qPrintable(remover.failedPaths().join(", ")));
+    QCOMPARE(remover.removedEntries(), entries);
+}
+
+void DiskRemoverTests::testReadOnlyFiles()
+{
+    //a working copy administrative area as svn leaves it
+    QString svnDir = m_treePath + "/wc/.svn";
+    QDir().mkpath(svnDir + "/text-base");
+    createFile(svnDir + "/entries");
+    createFile(svnDir + "/text-base/file.svn-base");
+    QFile::setPermissions(svnDir + "/entries", QFile::ReadOwner);
+    QFile::setPermissions(svnDir + "/text-base/file.svn-base", QFile::ReadOwner);
+    QFile::setPermissions(svnDir + "/text-base", QFile::ReadOwner | QFile::ExeOwner);
+    QFile::setPermissions(svnDir, QFile::ReadOwner | QFile::ExeOwner);
+
+    DiskRemover remover(this, QStringList(m_treePath));
+    remover.start();
+    QVERIFY2(remover.wait(30000), "The remover doesn't finish.");
+
+    QVERIFY2(!QFileInfo(m_treePath).exists(), "Read only files are left on the disk.");
+    QVERIFY2(remover.failedPaths().isEmpty(), qPrintable(remover.failedPaths().join(", ")));
+}
+
+void DiskRemoverTests::testSymLinkIsNotFollowed()
+{
+#if defined Q_OS_UNIX
+    createTree(m_outsidePath, 2, 2);
+    QDir().mkpath(m_treePath + "/wc");
+    QVERIFY(QFile::link(m_outsidePath, m_treePath + "/wc/link"));
+    QVERIFY(QFile::link(m_outsidePath + "/dir0/file0", m_treePath + "/wc/filelink"));
+
+    DiskRemover remover(this, QStringList(m_treePath));
+    remover.start();
+    QVERIFY2(remover.wait(30000), "The remover doesn't finish.");
+
+    QVERIFY2(!QFileInfo(m_treePath).exists(), "The tree is still on the disk.");
+    QVERIFY2(remover.failedPaths().isEmpty(), qPrintable(remover.failedPaths().join(", ")));
+    QVERIFY2(QFileInfo(m_outsidePath + "/dir0/file0").exists(), "The target of a link was removed.");
+    QVERIFY2(QFileInfo(m_outsidePath + "/dir1/file1").exists(), "A link to a directory was followed.");
+#else
+    QSKIP("Symbolic links are tested on Unix only.", SkipAll);
+#endif
+}
+
+void DiskRemoverTests::testDeepNesting()
+{
+    QString path = m_treePath;
+    for (int i = 0; i < NESTED_LEVELS; ++i)
+        path += "/d";
+    QVERIFY(QDir().mkpath(path));
+    createFile(path + "/file");
+
+    DiskRemover remover(this, QStringList(m_treePath));
+    remover.start();
+    QVERIFY2(remover.wait(30000), "The remover doesn't finish.");
+
+    QVERIFY2(!QFileInfo(m_treePath).exists(), "The nested tree is still on the disk.");
+    QVERIFY2(remover.failedPaths().isEmpty(), qPrintable(remover.failedPaths().join(", ")));
+    QCOMPARE(remover.removedEntries(), NESTED_LEVELS + 2);
+}
+
+void DiskRemoverTests::testMoveToTrash()
+{
+    createTree(m_treePath, 2, 2);
+    DiskRemover remover(this, QStringList(m_treePath), true);
+    remover.start();
+    QVERIFY2(remover.wait(30000), "The remover doesn't finish.");
+
+    QVERIFY2(!QFileInfo(m_treePath).exists(), "The tree is still on the disk.");
+    QCOMPARE(remover.trashPaths().count(), 1);
+    QVERIFY2(!QFileInfo(remover.trashPaths().first()).exists(), "The renamed tree is still on the disk.");
+}
+
+void DiskRemoverTests::testCancel()
+{
+    int entries = createTree(m_treePath, 100, 100);
+    DiskRemover remover(this, QStringList(m_treePath), true);
+    remover.start();
+    remover.cancel();
+    QVERIFY2(remover.wait(30000), "A canceled remover doesn't finish.");
+
+    QVERIFY(remover.isCanceled());
+    QVERIFY(remover.removedEntries() <= entries);
+    QVERIFY2(!QFileInfo(m_treePath).exists(), "The tree has to be renamed at once.");
+    QCOMPARE(remover.trashPaths().count(), 1);
+
+    //the rest is left in the renamed tree and can be removed later
+    QString trash = remover.trashPaths().first();
+    if (QFileInfo(trash).exists())
+        QVERIFY2(DiskRemover::removeFromDisk(trash), "The rest of a canceled removal can't be removed.");
+    QVERIFY(!QFileInfo(trash).exists());
+}
+
+QTEST_MAIN(DiskRemoverTests)
+#include "diskremovertests.moc"
@@ -0,0 +1,267 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnaction.h"
+#include "qsvnactions/qsvnactionscheduler.h"
+
+#include <QtTest/QtTest>
+#include <QMutex>
+#include <QStringList>
+
+
+class RecordingAction : public QSvnAction
+{
+    public:
+        RecordingAction(const QString &name, QStringList *log, QMutex *mutex, int duration = 50)
+            : m_name(name), m_log(log), m_mutex(mutex), m_duration(duration) {}
+
+    protected:
+        void run()
+        {
+            record("start " + m_name);
+            msleep(m_duration);
+            record("end " + m_name);
+        }
+
+    private:
+        QString m_name;
+        QStringList *m_log;
+        QMutex *m_mutex;
+        int m_duration;
+
+        void record(const QString &entry)
+        {
+            QMutexLocker locker(m_mutex);
+            m_log->append(entry);
+        }
+};
+
+class QSvnActionSchedulerTests: public QObject
+{
+    Q_OBJECT
+
+    private:
+        QStringList m_log;
+        QMutex m_mutex;
+        QList<RecordingAction*> m_actions;
+
+        RecordingAction *createAction(const QString &name, int duration = 50);
+        void waitForIdle();
+
+    private slots:
+        void init();
+        void cleanup();
+
+        void testPriorityOrder();
+        void testWcLock();
+        void testNestedWcLock();
+        void testSharedWc();
+        void testMaintenanceReader();
+        void testPrefetchReader();
+        void testWriterBeforeReader();
+        void testDependency();
+        void testFinishedDependency();
+        void testCancelQueued();
+        void testCancelDependency();
+};
+
+RecordingAction *QSvnActionSchedulerTests::createAction(const QString &name, int duration)
+{
+    RecordingAction *action = new RecordingAction(name, &m_log, &m_mutex, duration);
+    m_actions << action;
+    return action;
+}
+
+void QSvnActionSchedulerTests::waitForIdle()
+{
+    QTime time;
+    time.start();
+    while (!QSvnActionScheduler::instance()->isIdle() && time.elapsed() < 10000)
+        QTest::qWait(10);
+}
+
+void QSvnActionSchedulerTests::init()
+{
+    m_log.clear();
+    QSvnActionScheduler::instance()->setMaxRunning(4);
+    QSvnActionScheduler::instance()->setMaxPerServer(4);
+    QSvnActionScheduler::instance()->setMaxPerWc(1);
+}
+
+void QSvnActionSchedulerTests::cleanup()
+{
+    waitForIdle();
+    foreach (RecordingAction *action, m_actions)
+        action->wait();
+    qDeleteAll(m_actions);
+    m_actions.clear();
+}
+
+void QSvnActionSchedulerTests::testPriorityOrder()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->setMaxRunning(1);
+
+    scheduler->enqueue(createAction("blocker"), QSvnActionScheduler::Interactive);
+    scheduler->enqueue(createAction("maintenance"), QSvnActionScheduler::Maintenance);
+    scheduler->enqueue(createAction("prefetch"), QSvnActionScheduler::Prefetch);
+    scheduler->enqueue(createAction("interactive"), QSvnActionScheduler::Interactive);
+    waitForIdle();
+
+    QStringList starts = m_log.filter("start ");
+    QCOMPARE(starts, QStringList() << "start blocker" << "start interactive"
+                                   << "start prefetch" << "start maintenance");
+}
+
+void QSvnActionSchedulerTests::testWcLock()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->enqueue(createAction("first"), QSvnActionScheduler::Interactive, "", "/tmp/wc");
+    scheduler->enqueue(createAction("second"), QSvnActionScheduler::Interactive, "", "/tmp/wc");
+    waitForIdle();
+
+    QCOMPARE(m_log, QStringList() << "start first" << "end first"
+                                  << "start second" << "end second");
+}
+
+void QSvnActionSchedulerTests::testNestedWcLock()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->enqueue(createAction("parent"), QSvnActionScheduler::Interactive, "", "/tmp/wc");
+    scheduler->enqueue(createAction("child"), QSvnActionScheduler::Interactive, "", "/tmp/wc/sub");
+    waitForIdle();
+
+    QCOMPARE(m_log, QStringList() << "start parent" << "end parent"
+                                  << "start child" << "end child");
+}
+
+void QSvnActionSchedulerTests::testSharedWc()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->enqueue(createAction("first"), QSvnActionScheduler::Interactive, "", "/tmp/wc",
+                       QSvnActionScheduler::Shared);
+    scheduler->enqueue(createAction("second"), QSvnActionScheduler::Interactive, "", "/tmp/wc/sub",
+                       QSvnActionScheduler::Shared);
+    waitForIdle();
+
+    QCOMPARE(m_log.mid(0, 2), QStringList() << "start first" << "start second");
+}
+
+void QSvnActionSchedulerTests::testMaintenanceReader()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->enqueue(createAction("maintenance", 200), QSvnActionScheduler::Maintenance, "", "/tmp/wc",
+                       QSvnActionScheduler::Shared);
+    scheduler->enqueue(createAction("interactive"), QSvnActionScheduler::Interactive, "", "/tmp/wc");
+    waitForIdle();
+
+    QCOMPARE(m_log, QStringList() << "start maintenance" << "start interactive"
+                                  << "end interactive" << "end maintenance");
+}
+
+void QSvnActionSchedulerTests::testPrefetchReader()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->enqueue(createAction("prefetch", 200), QSvnActionScheduler::Prefetch, "", "/tmp/wc",
+                       QSvnActionScheduler::Shared);
+    scheduler->enqueue(createAction("interactive"), QSvnActionScheduler::Interactive, "", "/tmp/wc");
+    waitForIdle();
+
+    QCOMPARE(m_log, QStringList() << "start prefetch" << "start interactive"
+                                  << "end interactive" << "end prefetch");
+}
+
+void QSvnActionSchedulerTests::testWriterBeforeReader()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->enqueue(createAction("reader"), QSvnActionScheduler::Interactive, "", "/tmp/wc",
+                       QSvnActionScheduler::Shared);
+    scheduler->enqueue(createAction("writer"), QSvnActionScheduler::Interactive, "", "/tmp/wc");
+    scheduler->enqueue(createAction("late reader"), QSvnActionScheduler::Interactive, "", "/tmp/wc",
+                       QSvnActionScheduler::Shared);
+    waitForIdle();
+
+    QCOMPARE(m_log, QStringList() << "start reader" << "end reader"
+                                  << "start writer" << "end writer"
+                                  << "start late reader" << "end late reader");
+}
+
+void QSvnActionSchedulerTests::testDependency()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    RecordingAction *first = createAction("first");
+    RecordingAction *second = createAction("second");
+
+    int firstJob = scheduler->enqueue(first, QSvnActionScheduler::Maintenance);
+    scheduler->enqueue(second, QSvnActionScheduler::Interactive, "", "",
+                       QSvnActionScheduler::Exclusive, QList<int>() << firstJob);
+    waitForIdle();
+
+    QCOMPARE(m_log, QStringList() << "start first" << "end first"
+                                  << "start second" << "end second");
+}
+
+void QSvnActionSchedulerTests::testFinishedDependency()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    int firstJob = scheduler->enqueue(createAction("first"), QSvnActionScheduler::Interactive);
+    waitForIdle();
+
+    scheduler->enqueue(createAction("second"), QSvnActionScheduler::Interactive, "", "",
+                       QSvnActionScheduler::Exclusive, QList<int>() << firstJob);
+    waitForIdle();
+
+    QVERIFY2(m_log.contains("start second"), "A job depending on a finished job has to start.");
+}
+
+void QSvnActionSchedulerTests::testCancelQueued()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->setMaxRunning(1);
+    QSignalSpy spyCanceled(scheduler, SIGNAL(canceled(int)));
+
+    int running = scheduler->enqueue(createAction("running", 200), QSvnActionScheduler::Interactive);
+    int queued = scheduler->enqueue(createAction("queued"), QSvnActionScheduler::Interactive);
+
+    QVERIFY2(!scheduler->cancel(running), "A running job can't be canceled by the scheduler.");
+    QVERIFY2(scheduler->cancel(queued), "A queued job has to be cancelable.");
+    waitForIdle();
+
+    QVERIFY2(!m_log.contains("start queued"), "A canceled job was started.");
+    QCOMPARE(spyCanceled.count(), 1);
+}
+
+void QSvnActionSchedulerTests::testCancelDependency()
+{
+    QSvnActionScheduler *scheduler = QSvnActionScheduler::instance();
+    scheduler->setMaxRunning(1);
+
+    scheduler->enqueue(createAction("running", 200), QSvnActionScheduler::Interactive);
+    int queued = scheduler->enqueue(createAction("queued"), QSvnActionScheduler::Interactive);
+    scheduler->enqueue(createAction("dependent"), QSvnActionScheduler::Interactive,
+                       "", "", QSvnActionScheduler::Exclusive, QList<int>() << queued);
+    scheduler->cancel(queued);
+    waitForIdle();
+
+    QVERIFY2(!m_log.contains("start dependent"), "A job with a canceled dependency was started.");
+}
+
+QTEST_MAIN(QSvnActionSchedulerTests)
+#include "qsvnactionschedulertests.moc"
@@ -22,6 +22,8 @@
 #include "qsvnactions/qsvnclientcheckoutaction.h"
 #include "qsvnactions/qsvnrepositorycreateaction.h"
 
+#include "svnqt/client.hpp"
+#include "svnqt/context.hpp"
 #include "svnqt/wc.hpp"
 
 #include <QtTest/QtTest>
@@ -39,6 +41,8 @@ class QSvnClientCheckoutActionTests: public QObject
         QString m_reposPath;
         QDir m_wcDir;
 
+        QStringList checkout(const svn::Revision &revision, svn::Depth depth);
+
     private slots:
         void initTestCase();
         void cleanupTestCase();
@@ -46,6 +50,7 @@ class QSvnClientCheckoutActionTests: public QObject
 
         void testCheckoutFile();
         void testCheckoutHTTP();
+        void testCheckoutRevisionAndDepth();
         void testSignalNotify();
         void testSignalFinished();
         void tetsSignalFinishedNotOnError();
@@ -66,6 +71,13 @@ void QSvnClientCheckoutActionTests::initTestCase()
             new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
     action->start();
     while (action->isRunning()) {}
+
+    //revision 1 and 2 add one subdirectory each
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    client->mkdir(svn::Path("file:///" + m_reposPath + "/dir1"), "add dir1");
+    client->mkdir(svn::Path("file:///" + m_reposPath + "/dir2"), "add dir2");
+    delete client;
 }
 
 void QSvnClientCheckoutActionTests::cleanupTestCase()
@@ -102,6 +114,35 @@ void QSvnClientCheckoutActionTests::testCheckoutHTTP()
     QVERIFY2(svn::Wc::checkWc(m_wcDir.absolutePath()), "It's not a valid Working Copy.");
 }
 
+QStringList QSvnClientCheckoutActionTests::checkout(const svn::Revision &revision, svn::Depth depth)
+{
+    Helper::removeFromDisk(m_wcDir.absolutePath());
+    QSvnClientCheckoutAction *action =
+            new QSvnClientCheckoutAction("file:///" + m_reposPath, m_wcDir.absolutePath(), revision, depth);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    delete action;
+    if (spyFinished.count() != 1 || !svn::Wc::checkWc(m_wcDir.absolutePath()))
+        return QStringList("checkout failed");
+
+    //subdirectories without the administrative area
+    QStringList dirs = m_wcDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    dirs.removeAll(".svn");
+    dirs.sort();
+    return dirs;
+}
+
+void QSvnClientCheckoutActionTests::testCheckoutRevisionAndDepth()
+{
+    QCOMPARE(checkout(svn::Revision::HEAD, svn::DepthImmediates), QStringList() << "dir1" << "dir2");
+    QCOMPARE(checkout(svn::Revision(1), svn::DepthInfinity), QStringList("dir1"));
+    QVERIFY2(checkout(svn::Revision::HEAD, svn::DepthEmpty).isEmpty(),
+             "checkout with depth empty created subdirectories.");
+    QVERIFY2(checkout(svn::Revision::HEAD, svn::DepthFiles).isEmpty(),
+             "checkout with depth files created subdirectories.");
+}
+
 void QSvnClientCheckoutActionTests::testSignalNotify()
 {
     QSvnClientCheckoutAction *checkoutAction =
@@ -156,11 +197,13 @@ void QSvnClientCheckoutActionTests::testCancelAction()
 {
     QSvnClientCheckoutAction *checkoutAction =
             new QSvnClientCheckoutAction("file:///" + m_reposPath, m_wcDir.absolutePath());
+    QSignalSpy spyFinished(checkoutAction, SIGNAL(finished(QString)));
     QSignalSpy spyTerminated(checkoutAction, SIGNAL(terminated()));
     checkoutAction->start();
     checkoutAction->cancelAction();
     while (checkoutAction->isRunning()) {}
-    QVERIFY2(spyTerminated.count() != 0, "cancelAction don't terminate the QSvnAction.");
+    QVERIFY2(spyFinished.count() == 0, "A canceled checkout has finished.");
+    QVERIFY2(spyTerminated.count() == 0, "cancelAction has terminated the QSvnAction.");
 }
 
 
@@ -0,0 +1,150 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "helper.h"
+#include "qsvnactions/qsvnclientcheckoutaction.h"
+#include "qsvnactions/qsvnclientcommitaction.h"
+#include "qsvnactions/qsvnrepositorycreateaction.h"
+
+#include "svnqt/client.hpp"
+#include "svnqt/context.hpp"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+
+
+class QSvnClientCommitActionTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientCommitActionTests();
+
+    private:
+        QString m_reposPath;
+        QDir m_wcDir;
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testCommitAddedFile();
+        void testSignalFinishedNotOnError();
+        void testCancelAction();
+};
+
+QSvnClientCommitActionTests::QSvnClientCommitActionTests()
+{
+    m_reposPath = QDir::tempPath() + "/qsvncommittestrepo";
+    m_wcDir = QDir(QDir::tempPath() + QDir::separator() + "qsvncommittestwc");
+}
+
+void QSvnClientCommitActionTests::initTestCase()
+{
+    QSvnRepositoryCreateAction *createAction =
+            new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
+    createAction->start();
+    while (createAction->isRunning()) {}
+
+    QSvnClientCheckoutAction *checkoutAction =
+            new QSvnClientCheckoutAction(this, "file:///" + m_reposPath, m_wcDir.absolutePath());
+    checkoutAction->start();
+    while (checkoutAction->isRunning()) {}
+}
+
+void QSvnClientCommitActionTests::cleanupTestCase()
+{
+    Helper::removeFromDisk(m_wcDir.absolutePath());
+    Helper::removeFromDisk(m_reposPath);
+}
+
+void QSvnClientCommitActionTests::testCommitAddedFile()
+{
+    QFile file(m_wcDir.absoluteFilePath("added.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("added");
+    file.close();
+
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    client->add(svn::Path(file.fileName()), svn::DepthEmpty);
+    delete client;
+
+    QSvnClientCommitAction *action =
+            new QSvnClientCommitAction(QStringList(file.fileName()), "add a file");
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    QSignalSpy spyTransmitted(action, SIGNAL(fileTransmitted(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+    QVERIFY2(spyTransmitted.count() == 1, "signal fileTransmitted(QString) was not emitted for the file.");
+    QVERIFY2(action->transmittedFiles() == 1, "The file was not counted as transmitted.");
+    delete action;
+}
+
+void QSvnClientCommitActionTests::testSignalFinishedNotOnError()
+{
+    QSvnClientCommitAction *action =
+            new QSvnClientCommitAction(QStringList(QDir::tempPath() + QDir::separator() + "qsvncommittestnowc"),
+                                       "no working copy");
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "Don't call signal finished(QString) when an error occurred.");
+    delete action;
+}
+
+
+void QSvnClientCommitActionTests::testCancelAction()
+{
+    QFile file(m_wcDir.absoluteFilePath("canceled.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("canceled");
+    file.close();
+
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    client->add(svn::Path(file.fileName()), svn::DepthEmpty);
+    delete client;
+
+    QSvnClientCommitAction *action =
+            new QSvnClientCommitAction(QStringList(file.fileName()), "canceled commit");
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    QSignalSpy spyTerminated(action, SIGNAL(terminated()));
+    action->start();
+    action->cancelAction();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "A canceled commit has finished.");
+    QVERIFY2(spyTerminated.count() == 0, "cancelAction has terminated the commit.");
+    delete action;
+
+    //the canceled commit has released the working copy
+    action = new QSvnClientCommitAction(QStringList(file.fileName()), "commit again");
+    QSignalSpy spyRetry(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyRetry.count() == 1, "The working copy is still locked after a canceled commit.");
+    delete action;
+}
+
+QTEST_MAIN(QSvnClientCommitActionTests)
+#include "qsvnclientcommitactiontests.moc"
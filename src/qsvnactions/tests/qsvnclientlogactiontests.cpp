@@ -0,0 +1,136 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "helper.h"
+#include "qsvnactions/qsvnclientlogaction.h"
+#include "qsvnactions/qsvnrepositorycreateaction.h"
+
+#include "svnqt/client.hpp"
+#include "svnqt/context.hpp"
+#include "svnqt/log_entry.hpp"
+
+#include <QtTest/QtTest>
+#include <QDir>
+
+
+class QSvnClientLogActionTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientLogActionTests();
+
+    private:
+        QString m_reposPath;
+        QString m_reposUrl;
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testLogFromRevision();
+        void testLogStopsOnCopy();
+        void testStartAfterHead();
+        void testSignalFinishedNotOnError();
+};
+
+QSvnClientLogActionTests::QSvnClientLogActionTests()
+{
+    m_reposPath = QDir::tempPath() + "/qsvnlogtestrepo";
+    m_reposUrl = "file:///" + m_reposPath;
+}
+
+void QSvnClientLogActionTests::initTestCase()
+{
+    QSvnRepositoryCreateAction *action =
+            new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
+    action->start();
+    while (action->isRunning()) {}
+
+    //trunk in revision 1, the branch is copied from it in revision 2, trunk changes in revision 3
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    client->mkdir(svn::Path(m_reposUrl + "/trunk"), "add trunk");
+    client->copy(svn::Path(m_reposUrl + "/trunk"), svn::Revision::HEAD, svn::Path(m_reposUrl + "/branch"));
+    client->mkdir(svn::Path(m_reposUrl + "/trunk/dir"), "add dir");
+    delete client;
+}
+
+void QSvnClientLogActionTests::cleanupTestCase()
+{
+    Helper::removeFromDisk(m_reposPath);
+}
+
+void QSvnClientLogActionTests::testLogFromRevision()
+{
+    QSvnClientLogAction *action = new QSvnClientLogAction(this, m_reposUrl + "/trunk", 2);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+    QVERIFY2(action->headRevision() == 3, "The head revision was not read.");
+    QVERIFY2(action->logEntries().keys() == QList<svn_revnum_t>() << 3,
+             "The log doesn't start at the start revision.");
+    delete action;
+}
+
+void QSvnClientLogActionTests::testLogStopsOnCopy()
+{
+    QSvnClientLogAction *action = new QSvnClientLogAction(this, m_reposUrl + "/branch", 0, true, 1);
+    action->start();
+    while (action->isRunning()) {}
+    svn::LogEntriesMap entries = action->logEntries();
+    QVERIFY2(entries.keys() == QList<svn_revnum_t>() << 2, "The log of the branch doesn't stop at its copy.");
+
+    bool found = false;
+    foreach (svn::LogChangePathEntry changedPath, entries.value(2).changedPaths)
+    {
+        if (changedPath.path == "/branch")
+            found = changedPath.copyFromPath == "/trunk" && changedPath.copyFromRevision == 1;
+    }
+    QVERIFY2(found, "The copy source of the branch was not read.");
+    delete action;
+}
+
+void QSvnClientLogActionTests::testStartAfterHead()
+{
+    QSvnClientLogAction *action = new QSvnClientLogAction(this, m_reposUrl + "/trunk", 4);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+    QVERIFY2(action->headRevision() == 3, "The head revision was not read.");
+    QVERIFY2(action->logEntries().isEmpty(), "Revisions after the head were read.");
+    delete action;
+}
+
+void QSvnClientLogActionTests::testSignalFinishedNotOnError()
+{
+    QSvnClientLogAction *action = new QSvnClientLogAction(this, m_reposUrl + "/nonexistent");
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "Don't call signal finished(QString) when an error occurred.");
+    delete action;
+}
+
+QTEST_MAIN(QSvnClientLogActionTests)
+#include "qsvnclientlogactiontests.moc"
@@ -0,0 +1,211 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "helper.h"
+#include "qsvnactions/qsvnclientcheckoutaction.h"
+#include "qsvnactions/qsvnclientcommitaction.h"
+#include "qsvnactions/qsvnclientmergeaction.h"
+#include "qsvnactions/qsvnrepositorycreateaction.h"
+
+#include "svnqt/client.hpp"
+#include "svnqt/context.hpp"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+
+
+class QSvnClientMergeActionTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientMergeActionTests();
+
+    private:
+        QString m_reposPath;
+        QDir m_wcDir;
+
+        void writeFile(const QString &fileName, const QByteArray &content);
+        void commit(const QString &path, const QString &logMessage);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testDryRun();
+        void testDryRunRevisionRanges();
+        void testSignalFinishedNotOnError();
+        void testCancelAction();
+};
+
+QSvnClientMergeActionTests::QSvnClientMergeActionTests()
+{
+    m_reposPath = QDir::tempPath() + "/qsvnmergetestrepo";
+    m_wcDir = QDir(QDir::tempPath() + QDir::separator() + "qsvnmergetestwc");
+}
+
+void QSvnClientMergeActionTests::writeFile(const QString &fileName, const QByteArray &content)
+{
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(content);
+    file.close();
+}
+
+void QSvnClientMergeActionTests::commit(const QString &path, const QString &logMessage)
+{
+    QSvnClientCommitAction *action =
+            new QSvnClientCommitAction(QStringList(path), logMessage, svn::DepthInfinity);
+    action->start();
+    while (action->isRunning()) {}
+    delete action;
+}
+
+void QSvnClientMergeActionTests::initTestCase()
+{
+    QSvnRepositoryCreateAction *createAction =
+            new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
+    createAction->start();
+    while (createAction->isRunning()) {}
+
+    QSvnClientCheckoutAction *checkoutAction =
+            new QSvnClientCheckoutAction(this, "file:///" + m_reposPath, m_wcDir.absolutePath());
+    checkoutAction->start();
+    while (checkoutAction->isRunning()) {}
+}
+
+void QSvnClientMergeActionTests::cleanupTestCase()
+{
+    Helper::removeFromDisk(m_wcDir.absolutePath());
+    Helper::removeFromDisk(m_reposPath);
+}
+
+void QSvnClientMergeActionTests::testDryRun()
+{
+    QString fileName = m_wcDir.absoluteFilePath("merge.txt");
+    writeFile(fileName, "first\n");
+
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    client->add(svn::Path(fileName), svn::DepthEmpty);
+    delete client;
+    commit(m_wcDir.absolutePath(), "revision 1");
+
+    writeFile(fileName, "second\n");
+    commit(m_wcDir.absolutePath(), "revision 2");
+
+    //undo revision 2 only as dry run
+    QSvnClientMergeAction *action =
+            new QSvnClientMergeAction(this,
+                                      "file:///" + m_reposPath, svn::Revision(2),
+                                      "file:///" + m_reposPath, svn::Revision(1),
+                                      m_wcDir.absolutePath(), true);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+
+    bool found = false;
+    foreach (QSvnClientMergeAction::Entry entry, action->takeEntries())
+    {
+        if (QDir::cleanPath(QDir::fromNativeSeparators(entry.path)) == QDir::cleanPath(fileName))
+            found = entry.action == svn_wc_notify_update_update && !QSvnClientMergeAction::isConflict(entry);
+    }
+    QVERIFY2(found, "The dry run didn't report the update of the file.");
+    QVERIFY2(action->takeEntries().isEmpty(), "takeEntries() returned the same entries twice.");
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    QVERIFY2(file.readAll() == "second\n", "The dry run changed the working copy.");
+    delete action;
+}
+
+void QSvnClientMergeActionTests::testDryRunRevisionRanges()
+{
+    QString fileName = m_wcDir.absoluteFilePath("merge.txt");
+
+    //revert revision 2, given as a list of ranges
+    svn::RevisionRanges ranges;
+    ranges.append(svn::RevisionRange(svn::Revision(2), svn::Revision(1)));
+    QSvnClientMergeAction *action =
+            new QSvnClientMergeAction(this, "file:///" + m_reposPath, ranges,
+                                      m_wcDir.absolutePath(), true);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+
+    bool found = false;
+    foreach (QSvnClientMergeAction::Entry entry, action->takeEntries())
+    {
+        if (QDir::cleanPath(QDir::fromNativeSeparators(entry.path)) == QDir::cleanPath(fileName))
+            found = entry.action == svn_wc_notify_update_update;
+    }
+    QVERIFY2(found, "The dry run didn't report the update of the file.");
+    delete action;
+}
+
+void QSvnClientMergeActionTests::testSignalFinishedNotOnError()
+{
+    QSvnClientMergeAction *action =
+            new QSvnClientMergeAction(this,
+                                      "file:///" + m_reposPath, svn::Revision(1),
+                                      "file:///" + m_reposPath, svn::Revision(2),
+                                      QDir::tempPath() + QDir::separator() + "qsvnmergetestnowc", true);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "Don't call signal finished(QString) when an error occurred.");
+    delete action;
+}
+
+
+void QSvnClientMergeActionTests::testCancelAction()
+{
+    QSvnClientMergeAction *action =
+            new QSvnClientMergeAction(this,
+                                      "file:///" + m_reposPath, svn::Revision(2),
+                                      "file:///" + m_reposPath, svn::Revision(1),
+                                      m_wcDir.absolutePath(), false);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    QSignalSpy spyTerminated(action, SIGNAL(terminated()));
+    action->start();
+    action->cancelAction();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "A canceled merge has finished.");
+    QVERIFY2(spyTerminated.count() == 0, "cancelAction has terminated the merge.");
+    delete action;
+
+    //the canceled merge has released the working copy
+    action = new QSvnClientMergeAction(this,
+                                       "file:///" + m_reposPath, svn::Revision(2),
+                                       "file:///" + m_reposPath, svn::Revision(1),
+                                       m_wcDir.absolutePath(), true);
+    QSignalSpy spyRetry(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyRetry.count() == 1, "The working copy is still locked after a canceled merge.");
+    delete action;
+}
+
+QTEST_MAIN(QSvnClientMergeActionTests)
+#include "qsvnclientmergeactiontests.moc"
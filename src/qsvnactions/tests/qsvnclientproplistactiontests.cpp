@@ -0,0 +1,150 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "helper.h"
+#include "qsvnactions/qsvnclientcheckoutaction.h"
+#include "qsvnactions/qsvnclientproplistaction.h"
+#include "qsvnactions/qsvnrepositorycreateaction.h"
+
+#include "svnqt/client.hpp"
+#include "svnqt/client_parameter.hpp"
+#include "svnqt/context.hpp"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+
+
+class QSvnClientPropListActionTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientPropListActionTests();
+
+    private:
+        QString m_reposPath;
+        QDir m_wcDir;
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testListRecursive();
+        void testSignalFinishedNotOnError();
+        void testCancelAction();
+};
+
+QSvnClientPropListActionTests::QSvnClientPropListActionTests()
+{
+    m_reposPath = QDir::tempPath() + "/qsvnproplisttestrepo";
+    m_wcDir = QDir(QDir::tempPath() + QDir::separator() + "qsvnproplisttestwc");
+}
+
+void QSvnClientPropListActionTests::initTestCase()
+{
+    QSvnRepositoryCreateAction *createAction =
+            new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
+    createAction->start();
+    while (createAction->isRunning()) {}
+
+    QSvnClientCheckoutAction *checkoutAction =
+            new QSvnClientCheckoutAction(this, "file:///" + m_reposPath, m_wcDir.absolutePath());
+    checkoutAction->start();
+    while (checkoutAction->isRunning()) {}
+}
+
+void QSvnClientPropListActionTests::cleanupTestCase()
+{
+    Helper::removeFromDisk(m_wcDir.absolutePath());
+    Helper::removeFromDisk(m_reposPath);
+}
+
+void QSvnClientPropListActionTests::testListRecursive()
+{
+    QVERIFY(m_wcDir.mkdir("subdir"));
+    QFile file(m_wcDir.absoluteFilePath("subdir/file.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("file");
+    file.close();
+
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    client->add(svn::Path(m_wcDir.absoluteFilePath("subdir")), svn::DepthInfinity);
+    svn::PropertiesParameter params;
+    params
+            .propertyName("svn:eol-style")
+            .propertyValue("native")
+            .path(svn::Path(file.fileName()))
+            .depth(svn::DepthEmpty)
+            .revision(svn::Revision::WORKING);
+    client->propset(params);
+    delete client;
+
+    QSvnClientPropListAction *action =
+            new QSvnClientPropListAction(this, m_wcDir.absolutePath(), svn::DepthInfinity);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    QSignalSpy spyEntriesRead(action, SIGNAL(entriesRead()));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+    QVERIFY2(spyEntriesRead.count() == 2, "signal entriesRead() was not emitted for every directory.");
+
+    svn::PathPropertiesMapList entries = action->takeEntries();
+    bool found = false;
+    foreach (svn::PathPropertiesMapEntry entry, entries)
+    {
+        if (QDir::cleanPath(QDir::fromNativeSeparators(entry.first)) == QDir::cleanPath(file.fileName()))
+            found = entry.second.value("svn:eol-style") == "native";
+    }
+    QVERIFY2(found, "The property of the file in the subdirectory was not read.");
+    QVERIFY2(action->takeEntries().isEmpty(), "takeEntries() returned the same entries twice.");
+    delete action;
+}
+
+void QSvnClientPropListActionTests::testSignalFinishedNotOnError()
+{
+    QSvnClientPropListAction *action =
+            new QSvnClientPropListAction(this, QDir::tempPath() + QDir::separator() + "qsvnproplisttestnowc");
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "Don't call signal finished(QString) when an error occurred.");
+    delete action;
+}
+
+
+void QSvnClientPropListActionTests::testCancelAction()
+{
+    QSvnClientPropListAction *action =
+            new QSvnClientPropListAction(this, m_wcDir.absolutePath(), svn::DepthInfinity);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    QSignalSpy spyTerminated(action, SIGNAL(terminated()));
+    action->cancelAction();
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "A canceled list has finished.");
+    QVERIFY2(spyTerminated.count() == 0, "cancelAction has terminated the list.");
+    delete action;
+}
+
+QTEST_MAIN(QSvnClientPropListActionTests)
+#include "qsvnclientproplistactiontests.moc"
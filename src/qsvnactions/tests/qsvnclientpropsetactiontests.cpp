@@ -0,0 +1,162 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "helper.h"
+#include "qsvnactions/qsvnclientcheckoutaction.h"
+#include "qsvnactions/qsvnclientpropsetaction.h"
+#include "qsvnactions/qsvnrepositorycreateaction.h"
+
+#include "svnqt/client.hpp"
+#include "svnqt/context.hpp"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+
+
+class QSvnClientPropSetActionTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientPropSetActionTests();
+
+    private:
+        QString m_reposPath;
+        QDir m_wcDir;
+
+        QString propertyValue(const QString &path, const QString &name);
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testSetAndDelete();
+        void testSignalFinishedNotOnError();
+};
+
+QSvnClientPropSetActionTests::QSvnClientPropSetActionTests()
+{
+    m_reposPath = QDir::tempPath() + "/qsvnpropsettestrepo";
+    m_wcDir = QDir(QDir::tempPath() + QDir::separator() + "qsvnpropsettestwc");
+}
+
+QString QSvnClientPropSetActionTests::propertyValue(const QString &path, const QString &name)
+{
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    svn::PathPropertiesMapListPtr list =
+            client->proplist(path, svn::Revision::WORKING, svn::Revision::WORKING, svn::DepthEmpty);
+    delete client;
+
+    if (!list || list->isEmpty())
+        return QString();
+    return list->at(0).second.value(name);
+}
+
+void QSvnClientPropSetActionTests::initTestCase()
+{
+    QSvnRepositoryCreateAction *createAction =
+            new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
+    createAction->start();
+    while (createAction->isRunning()) {}
+
+    QSvnClientCheckoutAction *checkoutAction =
+            new QSvnClientCheckoutAction(this, "file:///" + m_reposPath, m_wcDir.absolutePath());
+    checkoutAction->start();
+    while (checkoutAction->isRunning()) {}
+}
+
+void QSvnClientPropSetActionTests::cleanupTestCase()
+{
+    Helper::removeFromDisk(m_wcDir.absolutePath());
+    Helper::removeFromDisk(m_reposPath);
+}
+
+void QSvnClientPropSetActionTests::testSetAndDelete()
+{
+    QStringList fileNames;
+    fileNames << m_wcDir.absoluteFilePath("first.txt") << m_wcDir.absoluteFilePath("second.txt");
+
+    svn::ContextP context = new svn::Context();
+    svn::Client *client = svn::Client::getobject(context, 0);
+    foreach (QString fileName, fileNames)
+    {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("file");
+        file.close();
+        client->add(svn::Path(fileName), svn::DepthEmpty);
+    }
+    delete client;
+
+    QSvnClientPropSetAction::Changes changes;
+    foreach (QString fileName, fileNames)
+    {
+        QSvnClientPropSetAction::Change change;
+        change.path = fileName;
+        change.name = "svn:mime-type";
+        change.value = "application/octet-stream";
+        change.remove = false;
+        changes << change;
+    }
+
+    QSvnClientPropSetAction *action = new QSvnClientPropSetAction(this, changes);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+    QVERIFY2(action->appliedChanges().count() == 2, "Not all changes were applied.");
+    foreach (QString fileName, fileNames)
+        QCOMPARE(propertyValue(fileName, "svn:mime-type"), QString("application/octet-stream"));
+    delete action;
+
+    changes.removeLast();
+    changes.first().remove = true;
+    action = new QSvnClientPropSetAction(this, changes);
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(propertyValue(fileNames.at(0), "svn:mime-type").isEmpty(), "The property was not deleted.");
+    QCOMPARE(propertyValue(fileNames.at(1), "svn:mime-type"), QString("application/octet-stream"));
+    delete action;
+}
+
+void QSvnClientPropSetActionTests::testSignalFinishedNotOnError()
+{
+    QSvnClientPropSetAction::Change change;
+    change.path = QDir::tempPath() + QDir::separator() + "qsvnpropsettestnowc";
+    change.name = "svn:eol-style";
+    change.value = "native";
+    change.remove = false;
+
+    QSvnClientPropSetAction *action =
+            new QSvnClientPropSetAction(this, QSvnClientPropSetAction::Changes() << change);
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "Don't call signal finished(QString) when an error occurred.");
+    QVERIFY2(action->appliedChanges().isEmpty(), "A failed change was reported as applied.");
+    delete action;
+}
+
+
+QTEST_MAIN(QSvnClientPropSetActionTests)
+#include "qsvnclientpropsetactiontests.moc"
@@ -0,0 +1,119 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+
+#include "helper.h"
+#include "qsvnactions/qsvnclientcheckoutaction.h"
+#include "qsvnactions/qsvnclientstatusaction.h"
+#include "qsvnactions/qsvnrepositorycreateaction.h"
+
+#include <QtTest/QtTest>
+#include <QDir>
+#include <QFile>
+
+
+class QSvnClientStatusActionTests: public QObject
+{
+    Q_OBJECT
+
+    public:
+        QSvnClientStatusActionTests();
+
+    private:
+        QString m_reposPath;
+        QDir m_wcDir;
+
+    private slots:
+        void initTestCase();
+        void cleanupTestCase();
+
+        void testCleanWc();
+        void testUnversionedFile();
+        void testSignalFinishedNotOnError();
+};
+
+QSvnClientStatusActionTests::QSvnClientStatusActionTests()
+{
+    m_reposPath = QDir::tempPath() + "/qsvnstatustestrepo";
+    m_wcDir = QDir(QDir::tempPath() + QDir::separator() + "qsvnstatustestwc");
+}
+
+void QSvnClientStatusActionTests::initTestCase()
+{
+    QSvnRepositoryCreateAction *createAction =
+            new QSvnRepositoryCreateAction(this, m_reposPath, "fsfs");
+    createAction->start();
+    while (createAction->isRunning()) {}
+
+    QSvnClientCheckoutAction *checkoutAction =
+            new QSvnClientCheckoutAction(this, "file:///" + m_reposPath, m_wcDir.absolutePath());
+    checkoutAction->start();
+    while (checkoutAction->isRunning()) {}
+}
+
+void QSvnClientStatusActionTests::cleanupTestCase()
+{
+    Helper::removeFromDisk(m_wcDir.absolutePath());
+    Helper::removeFromDisk(m_reposPath);
+}
+
+void QSvnClientStatusActionTests::testCleanWc()
+{
+    QSvnClientStatusAction *action = new QSvnClientStatusAction(m_wcDir.absolutePath());
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 1, "signal finished(QString) was not emitted.");
+    QVERIFY2(action->statusEntries().isEmpty(), "A clean working copy has no interesting entries.");
+    delete action;
+}
+
+void QSvnClientStatusActionTests::testUnversionedFile()
+{
+    QFile file(m_wcDir.absoluteFilePath("unversioned.txt"));
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("unversioned");
+    file.close();
+
+    QSvnClientStatusAction *action = new QSvnClientStatusAction(m_wcDir.absolutePath());
+    action->start();
+    while (action->isRunning()) {}
+    svn::StatusEntries entries = action->statusEntries();
+    delete action;
+    file.remove();
+
+    QVERIFY2(entries.count() == 1, "The unversioned file was not reported.");
+    QVERIFY2(entries.at(0)->textStatus() == svn_wc_status_unversioned, "The file is not reported as unversioned.");
+}
+
+void QSvnClientStatusActionTests::testSignalFinishedNotOnError()
+{
+    QSvnClientStatusAction *action =
+            new QSvnClientStatusAction(QDir::tempPath() + QDir::separator() + "qsvnstatustestnowc");
+    QSignalSpy spyFinished(action, SIGNAL(finished(QString)));
+    action->start();
+    while (action->isRunning()) {}
+    QVERIFY2(spyFinished.count() == 0, "Don't call signal finished(QString) when an error occurred.");
+    delete action;
+}
+
+
+QTEST_MAIN(QSvnClientStatusActionTests)
+#include "qsvnclientstatusactiontests.moc"
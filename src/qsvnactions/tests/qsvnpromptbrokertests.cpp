@@ -0,0 +1,147 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#include "qsvnactions/qsvnpromptbroker.h"
+
+#include <QtTest/QtTest>
+#include <QThread>
+
+
+class PromptWaiter : public QThread
+{
+    public:
+        PromptWaiter(const QString &key, int timeout = PROMPT_TIMEOUT)
+            : m_key(key), m_timeout(timeout), raised(false), result(QSvnPromptBroker::TimedOut) {}
+
+        QAtomicInt canceled;
+        bool raised;
+        QSvnPromptBroker::Result result;
+        QSvnPromptAnswer answer;
+
+    protected:
+        void run()
+        {
+            raised = QSvnPromptBroker::instance()->acquire(m_key);
+            result = QSvnPromptBroker::instance()->wait(m_key, answer, canceled, m_timeout);
+        }
+
+    private:
+        QString m_key;
+        int m_timeout;
+};
+
+class QSvnPromptBrokerTests: public QObject
+{
+    Q_OBJECT
+
+    private:
+        void waitForWaiters(const QString &key, int count);
+
+    private slots:
+        void testAnswerIsShared();
+        void testAbort();
+        void testCancel();
+        void testTimeout();
+        void testAnsweredPromptIsNotJoined();
+};
+
+void QSvnPromptBrokerTests::waitForWaiters(const QString &key, int count)
+{
+    QTime time;
+    time.start();
+    while (QSvnPromptBroker::instance()->waiters(key) < count && time.elapsed() < 5000)
+        QTest::qWait(10);
+}
+
+void QSvnPromptBrokerTests::testAnswerIsShared()
+{
+    PromptWaiter first("login:shared"), second("login:shared");
+    first.start();
+    waitForWaiters("login:shared", 1);
+    second.start();
+    waitForWaiters("login:shared", 2);
+
+    QSvnPromptAnswer answer;
+    answer.username = "user";
+    answer.password = "secret";
+    QSvnPromptBroker::instance()->answer("login:shared", answer);
+    first.wait();
+    second.wait();
+
+    QVERIFY2(first.raised, "The first waiter has to raise the prompt.");
+    QVERIFY2(!second.raised, "The second waiter must not raise a prompt for the same key.");
+    QCOMPARE(first.result, QSvnPromptBroker::Answered);
+    QCOMPARE(second.result, QSvnPromptBroker::Answered);
+    QCOMPARE(second.answer.username, QString("user"));
+    QCOMPARE(QSvnPromptBroker::instance()->waiters("login:shared"), 0);
+}
+
+void QSvnPromptBrokerTests::testAbort()
+{
+    PromptWaiter waiter("login:abort");
+    waiter.start();
+    waitForWaiters("login:abort", 1);
+    QSvnPromptBroker::instance()->abort("login:abort");
+    waiter.wait();
+    QCOMPARE(waiter.result, QSvnPromptBroker::Aborted);
+}
+
+void QSvnPromptBrokerTests::testCancel()
+{
+    PromptWaiter waiter("login:cancel");
+    waiter.start();
+    waitForWaiters("login:cancel", 1);
+    waiter.canceled = 1;
+    QVERIFY2(waiter.wait(5000), "A canceled waiter doesn't return.");
+    QCOMPARE(waiter.result, QSvnPromptBroker::Canceled);
+}
+
+void QSvnPromptBrokerTests::testTimeout()
+{
+    PromptWaiter waiter("login:timeout", 50);
+    waiter.start();
+    QVERIFY2(waiter.wait(5000), "A waiter doesn't return after its timeout.");
+    QCOMPARE(waiter.result, QSvnPromptBroker::TimedOut);
+}
+
+void QSvnPromptBrokerTests::testAnsweredPromptIsNotJoined()
+{
+    QSvnPromptBroker *broker = QSvnPromptBroker::instance();
+    QAtomicInt canceled;
+    QVERIFY(broker->acquire("login:retry"));
+    QSvnPromptAnswer answer;
+    answer.username = "wrong";
+    broker->answer("login:retry", answer);
+
+    //the first waiter hasn't returned yet, a retry has to raise its own prompt
+    PromptWaiter retry("login:retry", 50);
+    retry.start();
+    QVERIFY2(retry.wait(5000), "A waiter doesn't return after its timeout.");
+    QVERIFY2(retry.raised, "A retry joined an answered prompt.");
+    QCOMPARE(retry.result, QSvnPromptBroker::TimedOut);
+
+    QSvnPromptAnswer received;
+    QCOMPARE(broker->wait("login:retry", received, canceled), QSvnPromptBroker::Answered);
+    QCOMPARE(received.username, QString("wrong"));
+    QCOMPARE(broker->waiters("login:retry"), 0);
+}
+
+QTEST_MAIN(QSvnPromptBrokerTests)
+#include "qsvnpromptbrokertests.moc"
@@ -215,6 +215,11 @@ void ShowLog::selectionChanged(const QItemSelection &selected,
             m_logChangePathEntriesModel->setChangePathEntries(m_logEntriesModel->getLogEntry(index).changedPaths);
         }
     }
+
+    //merge and revert work on all selected revisions, the editors only on one
+    bool singleRevision = viewLogEntries->selectionModel()->selectedRows().count() == 1;
+    actionEditLogMessage->setEnabled(singleRevision);
+    actionEditAuthor->setEnabled(singleRevision);
 }
 
 void ShowLog::on_checkBoxStrictNodeHistory_stateChanged()
@@ -232,10 +237,23 @@ svn::Revision ShowLog::getSelectedRevision()
     indexes = viewLogEntries->selectionModel()->selectedIndexes();
     if (indexes.count() == 0)
         return svn::Revision(svn::Revision::UNDEFINED);
-    logEntry = m_logEntriesModel->getLogEntry(m_logEntriesProxy->mapToSource(indexes.at(0)));
+    //with several selected revisions, the current one is meant
+    QModelIndex index = viewLogEntries->selectionModel()->currentIndex();
+    if (!index.isValid() || !viewLogEntries->selectionModel()->isSelected(index))
+        index = indexes.at(0);
+    logEntry = m_logEntriesModel->getLogEntry(m_logEntriesProxy->mapToSource(index));
     return logEntry.revision;
 }
 
+QList<svn_revnum_t> ShowLog::getSelectedRevisions()
+{
+    QList<svn_revnum_t> revisions;
+    foreach (QModelIndex index, viewLogEntries->selectionModel()->selectedRows())
+        revisions << m_logEntriesModel->getLogEntry(m_logEntriesProxy->mapToSource(index)).revision;
+    qSort(revisions);
+    return revisions;
+}
+
 QString ShowLog::getSelectedPath()
 {
     svn::LogChangePathEntry logChangePathEntry;
@@ -339,17 +357,24 @@ void ShowLog::on_comboBoxFilterKeyColumn_currentIndexChanged(int index)
 
 void ShowLog::on_actionMerge_triggered( )
 {
-    Merge::doMerge(m_url, svn::Revision(getSelectedRevision().revnum() - 1),
-                   m_url, getSelectedRevision(),
-                   m_path);
+    //all selected revisions are merged in one pass, the oldest first
+    svn::RevisionRanges ranges = SvnClient::revisionRanges(getSelectedRevisions());
+    if (ranges.isEmpty())
+        return;
+
+    if (ranges.count() == 1)
+        Merge::doMerge(m_url, ranges.first().first,
+                       m_url, ranges.first().second,
+                       m_path);
+    else
+        Merge::doMerge(m_url, ranges, m_path);
 }
 
 void ShowLog::on_actionRevertChangeset_triggered()
 {
     QString _url = m_url;
     QString _path = m_path;
-    svn::Revision _rev = getSelectedRevision();
-    revertChanges(_url, _path, _rev);
+    revertChanges(_url, _path, getSelectedRevisions());
 }
 
 void ShowLog::on_actionRevertPath_triggered()
@@ -358,31 +383,45 @@ void ShowLog::on_actionRevertPath_triggered()
     {
         QString _url = m_repos + getSelectedPath();
         QString _path = m_path + QString(getSelectedPath()).remove(m_repos_path);
-        svn::Revision _rev = getSelectedRevision();
-        revertChanges(_url, _path, _rev);
+        revertChanges(_url, _path, getSelectedRevisions());
     }
 }
 
-void ShowLog::revertChanges(const QString url, const QString path, const svn::Revision revision)
+void ShowLog::revertChanges(const QString url, const QString path, const QList<svn_revnum_t> &revisions)
 {
+    if (revisions.isEmpty())
+        return;
+
+    QStringList revisionList;
+    foreach (svn_revnum_t revision, revisions)
+        revisionList << QString::number(revision);
+
     if (QMessageBox::question(
         this,
         tr("Revert"),
            tr("Do you really want to revert all changes from revision %1 in\n%2?")
-                   .arg(revision.revnum())
+                   .arg(revisionList.join(", "))
                    .arg(path),
                         QMessageBox::Yes, QMessageBox::No) == QMessageBox::Yes)
     {
-        if (SvnClient::instance()->merge(
-            url, revision,
-            url, svn::Revision(revision.revnum() - 1),
-            path, true, true))
+        //the youngest revision is reverted first
+        svn::RevisionRanges ranges = SvnClient::revisionRanges(revisions, true);
+        bool reverted;
+        if (ranges.count() == 1)
+            reverted = SvnClient::instance()->merge(
+                    url, ranges.first().first,
+                    url, ranges.first().second,
+                    path, true, true);
+        else
+            reverted = SvnClient::instance()->merge(url, ranges, path, true, true);
+
+        if (reverted)
         {
             QMessageBox::information(
                                      this,
                                      tr("Revert"),
                                      tr("All changes from revision %1 successfully reverted in\n%2.")
-                                         .arg(revision.revnum())
+                                         .arg(revisionList.join(", "))
                                          .arg(path));
         }
     }
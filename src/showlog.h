@@ -70,10 +70,11 @@ class ShowLog : public QDialog, public Ui::ShowLog
         void initMenus();
 
         svn::Revision getSelectedRevision();
+        QList<svn_revnum_t> getSelectedRevisions();
         QString getSelectedPath();
         bool checkLocatedInWc();
         svn_revnum_t getSelectedStartRevision();
-        void revertChanges(const QString url, const QString path, const svn::Revision revision);
+        void revertChanges(const QString url, const QString path, const QList<svn_revnum_t> &revisions);
 
     private slots:
         void selectionChanged(const QItemSelection &selected, const QItemSelection &deselected);
@@ -22,24 +22,37 @@
 #include "statusentriesmodel.h"
 #include "statusentriesmodel.moc"
 #include "svnclient.h"
+#include "qsvnactions/qsvnactionscheduler.h"
+#include "qsvnactions/qsvnclientstatusaction.h"
 
 //SvnQt
 #include "svnqt/client.hpp"
 #include "svnqt/status.hpp"
+#include "svnqt/wc.hpp"
 
 //Qt
 #include <QtCore>
 #include <QtGui>
 
 
+//more changed paths than this are read with one status call for the whole directory
+#define MAX_PATH_UPDATES 100
+
+
 StatusEntriesModel::StatusEntriesModel(QObject *parent)
         : QAbstractTableModel(parent)
 {
     m_statusEntries = svn::StatusEntries();
+    m_scanDone = 0;
+    m_scanTotal = 0;
+
+    for (int kind = 0; kind <= svn_wc_status_incomplete; ++kind)
+        m_statusStrings << statusString(svn_wc_status_kind(kind));
 }
 
 StatusEntriesModel::~StatusEntriesModel()
 {
+    cancelScan();
 }
 
 int StatusEntriesModel::rowCount(const QModelIndex &parent) const
@@ -85,7 +98,7 @@ QVariant StatusEntriesModel::data(const QModelIndex &index, int role) const
     if (!index.isValid())
         return QVariant();
 
-    svn::StatusPtr status = m_statusEntries.at(index.row());
+    const svn::StatusPtr &status = m_statusEntries.at(index.row());
 
     switch (role)
     {
@@ -93,20 +106,13 @@ QVariant StatusEntriesModel::data(const QModelIndex &index, int role) const
             switch (index.column())
             {
                 case 0: //FileName
-                    if (!status->isVersioned() ||  //return path for unversioned Files
-                         m_depth > svn::DepthFiles)
-                    {
-                        QString path = QDir::toNativeSeparators(status->path());
-                        return path.remove(0, m_directory.size());
-                    }
-                    else
-                        return status->entry().name();
+                    return m_rowData.at(index.row()).fileName;
                     break;
                 case 1: //Text-Status
-                    return statusString(status->textStatus());
+                    return m_statusStrings.value(status->textStatus());
                     break;
                 case 2: //Property-Status
-                    return statusString(status->propStatus());
+                    return m_statusStrings.value(status->propStatus());
                     break;
                 case 3: //Revision
                     if (status->isVersioned())
@@ -119,7 +125,7 @@ QVariant StatusEntriesModel::data(const QModelIndex &index, int role) const
             break;
         case Qt::DecorationRole:
             if (index.column() == 0)
-                return statusPixmap(status);
+                return statusPixmaps().at(m_rowData.at(index.row()).icon);
             break;
     }
     return QVariant();
@@ -128,47 +134,416 @@ QVariant StatusEntriesModel::data(const QModelIndex &index, int role) const
 void StatusEntriesModel::readDirectory(QString directory, svn::Depth depth,
                                        const bool force)
 {
+    cancelScan();
     emit beginUpdate();
     directory = QDir::cleanPath(directory) + QDir::separator();
     directory = QDir::toNativeSeparators(directory);
     if (force || (m_directory != directory))
     {
-        m_depth = depth;
-        m_directory = directory;
-        m_statusEntries = SvnClient::instance()->status(m_directory, m_depth);
+        svn::StatusEntries entries = SvnClient::instance()->status(directory, depth);
 #if defined Q_WS_WIN32
-        checkCaseSensitivity();
+        checkCaseSensitivity(entries);
 #endif
-        emit layoutChanged();
+        //the same directory again only updates the rows that changed
+        if ((m_directory == directory) && (m_depth == depth))
+            applyEntries(entries);
+        else
+        {
+            m_depth = depth;
+            m_directory = directory;
+            m_statusEntries = entries;
+            updateRowIndex();
+            updateRowData();
+            reset();
+        }
+        emit statusRead(m_directory, m_statusEntries);
     }
     emit endUpdate();
 }
 
 void StatusEntriesModel::readFileList(QStringList fileList)
 {
+    cancelScan();
+    m_roots.clear();
     emit beginUpdate();
+    svn::StatusEntries entries = SvnClient::instance()->status(fileList);
+
+    if (m_fileList == fileList)
+        applyEntries(entries);
+    else
+    {
+        m_fileList = fileList;
+        m_statusEntries = entries;
+        updateRowIndex();
+        updateRowData();
+        reset();
+    }
+    emit endUpdate();
+}
+
+void StatusEntriesModel::scanDirectories(const QStringList &directories)
+{
+    cancelScan();
+    emit scanStarted();
+    m_roots.clear();
+    foreach (QString directory, collapsePaths(directories))
+        m_roots << QDir::toNativeSeparators(QDir::cleanPath(directory) + QDir::separator());
+
+    //refresh() and updatePaths() work with a single directory only
+    m_fileList.clear();
+    m_directory = (m_roots.count() == 1) ? m_roots.first() : QString();
+    m_depth = svn::DepthInfinity;
     m_statusEntries.clear();
+    updateRowIndex();
+    updateRowData();
+
+    m_scanDone = 0;
+    m_scanTotal = 0;
+    m_scanRoots.clear();
+    foreach (QString root, m_roots)
+    {
+        if (!svn::Wc::checkWc(root))
+            continue;
+        QString path = QDir(root).canonicalPath();
+        m_scanRoots.insert(pathKey(path));
+        enqueueScan(path, svn::DepthImmediates);
+    }
+    //after the scan is queued, so views know the rows are still coming
+    reset();
+    if (m_scanJobs.isEmpty())
+        emit scanFinished();
+}
+
+QStringList StatusEntriesModel::collapsePaths(const QStringList &paths)
+{
+    //with a trailing separator the paths below a path follow it directly after sorting
+    QStringList keys;
+    foreach (QString path, paths)
+        keys << pathKey(path) + QDir::separator();
+    qSort(keys);
+
+    QStringList result;
+    QString last;
+    foreach (QString key, keys)
+    {
+        if (!last.isEmpty() && key.startsWith(last))
+            continue;
+        last = key;
+        result << pathKey(key);
+    }
+    return result;
+}
+
+QStringList StatusEntriesModel::rootDirectories() const
+{
+    return m_roots;
+}
+
+void StatusEntriesModel::enqueueScan(const QString &path, svn::Depth depth)
+{
+    QSvnClientStatusAction *action = new QSvnClientStatusAction(path, depth, true);
+    action->setReadFileInfos(true);
+    connect(action, SIGNAL(finished()), this, SLOT(onScanActionFinished()));
+    connect(action, SIGNAL(finished()), action, SLOT(deleteLater()));
+    //status only reads, the scans of the subdirectories run side by side
+    m_scanJobs.insert(action, QSvnActionScheduler::instance()->enqueue(action, QSvnActionScheduler::Interactive,
+                                                                       QString(), m_directory,
+                                                                       QSvnActionScheduler::Shared));
+    ++m_scanTotal;
+}
+
+void StatusEntriesModel::cancelScan()
+{
+    //running actions finish in the background, their result is dropped
+    QHashIterator<QSvnClientStatusAction*, int> it(m_scanJobs);
+    while (it.hasNext())
+    {
+        it.next();
+        disconnect(it.key(), SIGNAL(finished()), this, SLOT(onScanActionFinished()));
+        if (QSvnActionScheduler::instance()->cancel(it.value()))
+            delete it.key();
+    }
+    m_scanJobs.clear();
+}
+
+bool StatusEntriesModel::isScanning() const
+{
+    return !m_scanJobs.isEmpty();
+}
+
+void StatusEntriesModel::onScanActionFinished()
+{
+    QSvnClientStatusAction *action = qobject_cast<QSvnClientStatusAction*>(sender());
+    if (!action || !m_scanJobs.contains(action))
+        return;
+    m_scanJobs.remove(action);
+    ++m_scanDone;
+
+    svn::StatusEntries entries = action->statusEntries();
+#if defined Q_WS_WIN32
+    checkCaseSensitivity(entries);
+#endif
+    upsertEntries(entries, action->fileInfos());
+
+    //the first pass lists a directory itself, go on with its versioned subdirectories
+    QString root = pathKey(action->path());
+    if (m_scanRoots.contains(root))
+    {
+        foreach (svn::StatusPtr status, entries)
+        {
+            if (status->isVersioned() &&
+                status->entry().kind() == svn_node_dir &&
+                pathKey(status->path()) != root)
+                enqueueScan(status->path(), svn::DepthInfinity);
+        }
+    }
+
+    emit scanProgress(m_scanDone, m_scanTotal);
+    if (m_scanJobs.isEmpty())
+    {
+        foreach (QString directory, m_roots)
+            emit statusRead(directory, m_statusEntries);
+        emit scanFinished();
+    }
+}
+
+void StatusEntriesModel::upsertEntries(const svn::StatusEntries &entries,
+                                       const QHash<QString, QSvnClientStatusAction::FileInfo> &infos)
+{
+    svn::StatusEntries newEntries;
+    foreach (svn::StatusPtr status, entries)
+    {
+        QString key = pathKey(status->path());
+        QHash<QString, QSvnClientStatusAction::FileInfo>::const_iterator info = infos.constFind(status->path());
+        int row = m_rows.value(key, -1);
+        if (row < 0)
+        {
+            m_rows.insert(key, m_statusEntries.count() + newEntries.count());
+            newEntries.append(status);
+        }
+        else if (row < m_statusEntries.count())
+        {
+            bool changed = !isSameStatus(m_statusEntries.at(row), status);
+            m_statusEntries[row] = status;
+            if (changed)
+            {
+                m_rowData[row] = rowData(status, info != infos.constEnd() ? &info.value() : 0);
+                emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+            }
+            else if (info != infos.constEnd())
+                m_rowData[row].size = info.value().size;
+        }
+    }
+
+    if (!newEntries.isEmpty())
+    {
+        beginInsertRows(QModelIndex(), m_statusEntries.count(), m_statusEntries.count() + newEntries.count() - 1);
+        m_statusEntries << newEntries;
+        foreach (svn::StatusPtr status, newEntries)
+        {
+            QHash<QString, QSvnClientStatusAction::FileInfo>::const_iterator info = infos.constFind(status->path());
+            m_rowData.append(rowData(status, info != infos.constEnd() ? &info.value() : 0));
+        }
+        endInsertRows();
+    }
+}
+
+void StatusEntriesModel::applyEntries(const svn::StatusEntries &entries)
+{
+    QHash<QString, int> newRows;
+    for (int i = 0; i < entries.count(); ++i)
+        newRows.insert(pathKey(entries.at(i)->path()), i);
+
+    //remove vanished rows, a range at once and from the end
+    int row = m_statusEntries.count() - 1;
+    while (row >= 0)
+    {
+        if (newRows.contains(pathKey(m_statusEntries.at(row)->path())))
+        {
+            --row;
+            continue;
+        }
+        int last = row;
+        while (row > 0 && !newRows.contains(pathKey(m_statusEntries.at(row - 1)->path())))
+            --row;
+        beginRemoveRows(QModelIndex(), row, last);
+        m_statusEntries.erase(m_statusEntries.begin() + row, m_statusEntries.begin() + last + 1);
+        m_rowData.remove(row, last - row + 1);
+        endRemoveRows();
+        --row;
+    }
+
+    //take over the new status of the remaining rows
+    QSet<QString> knownPaths;
+    int firstChanged = -1;
+    for (row = 0; row <= m_statusEntries.count(); ++row)
+    {
+        bool changed = false;
+        if (row < m_statusEntries.count())
+        {
+            QString key = pathKey(m_statusEntries.at(row)->path());
+            knownPaths.insert(key);
+            svn::StatusPtr status = entries.at(newRows.value(key));
+            changed = !isSameStatus(m_statusEntries.at(row), status);
+            m_statusEntries[row] = status;
+            if (changed)
+                m_rowData[row] = rowData(status);
+            else
+                m_rowData[row].size = -1; //the file may be edited again, read the size on the next use
+        }
+
+        if (changed && firstChanged < 0)
+            firstChanged = row;
+        else if (!changed && firstChanged >= 0)
+        {
+            emit dataChanged(index(firstChanged, 0), index(row - 1, columnCount() - 1));
+            firstChanged = -1;
+        }
+    }
 
-    m_fileList = fileList;
-    foreach (QString file, m_fileList)
+    //append new rows
+    svn::StatusEntries newEntries;
+    foreach (svn::StatusPtr status, entries)
     {
-        if (QFile::exists(file))
+        if (!knownPaths.contains(pathKey(status->path())))
+            newEntries.append(status);
+    }
+    if (!newEntries.isEmpty())
+    {
+        beginInsertRows(QModelIndex(), m_statusEntries.count(), m_statusEntries.count() + newEntries.count() - 1);
+        m_statusEntries << newEntries;
+        foreach (svn::StatusPtr status, newEntries)
+            m_rowData.append(rowData(status));
+        endInsertRows();
+    }
+
+    updateRowIndex();
+}
+
+bool StatusEntriesModel::isSameStatus(const svn::StatusPtr status1, const svn::StatusPtr status2)
+{
+    return (status1->textStatus() == status2->textStatus()) &&
+           (status1->propStatus() == status2->propStatus()) &&
+           (status1->isVersioned() == status2->isVersioned()) &&
+           (status1->entry().cmtRev() == status2->entry().cmtRev()) &&
+           (status1->entry().cmtAuthor() == status2->entry().cmtAuthor());
+}
+
+void StatusEntriesModel::updatePaths(const QStringList &paths)
+{
+    if (m_directory.isEmpty())
+        return;
+
+    QString directory = pathKey(m_directory);
+    QSet<QString> changedPaths;
+    foreach (QString path, paths)
+    {
+        path = pathKey(path);
+        if (path != directory && pathKey(QFileInfo(path).path()) != directory)
+            continue;
+
+        //a bulk change is read again at once
+        changedPaths.insert(path);
+        if (changedPaths.count() > MAX_PATH_UPDATES || m_depth > svn::DepthFiles)
+        {
+            refresh();
+            return;
+        }
+    }
+    if (changedPaths.isEmpty())
+        return;
+
+    emit beginUpdate();
+    svn::StatusEntries changedEntries;
+    QList<int> removedRows;
+    foreach (QString path, changedPaths)
+    {
+        int row = m_rows.value(path, -1);
+
+        //unversioned files are gone, when they don't exist anymore
+        if (!QFile::exists(path) && (row < 0 || !m_statusEntries.at(row)->isVersioned()))
+        {
+            if (row >= 0)
+                removedRows << row;
+            continue;
+        }
+
+        svn::StatusPtr status = SvnClient::instance()->singleStatus(path);
+        if (status->textStatus() == svn_wc_status_none ||
+            status->textStatus() == svn_wc_status_ignored)
+        {
+            if (row >= 0)
+                removedRows << row;
+            continue;
+        }
+
+        changedEntries.append(status);
+        if (row >= 0)
         {
-            m_statusEntries.append(SvnClient::instance()->singleStatus(file));
+            m_statusEntries[row] = status;
+            m_rowData[row] = rowData(status);
+            emit dataChanged(index(row, 0), index(row, columnCount() - 1));
+        }
+        else
+        {
+            beginInsertRows(QModelIndex(), m_statusEntries.count(), m_statusEntries.count());
+            m_statusEntries.append(status);
+            m_rowData.append(rowData(status));
+            m_rows.insert(path, m_statusEntries.count() - 1);
+            endInsertRows();
         }
     }
+
+    //remove from the end, so the other rows stay valid
+    qSort(removedRows.begin(), removedRows.end(), qGreater<int>());
+    foreach (int row, removedRows)
+    {
+        beginRemoveRows(QModelIndex(), row, row);
+        m_statusEntries.removeAt(row);
+        m_rowData.remove(row);
+        endRemoveRows();
+    }
+    if (!removedRows.isEmpty())
+        updateRowIndex(removedRows.last());
+
+    emit statusChanged(changedPaths.toList(), changedEntries);
     emit endUpdate();
 }
 
+void StatusEntriesModel::updateRowIndex(int from)
+{
+    if (from == 0)
+        m_rows.clear();
+    else
+    {
+        QMutableHashIterator<QString, int> it(m_rows);
+        while (it.hasNext())
+        {
+            if (it.next().value() >= from)
+                it.remove();
+        }
+    }
+
+    for (int row = from; row < m_statusEntries.count(); ++row)
+        m_rows.insert(pathKey(m_statusEntries.at(row)->path()), row);
+}
+
+QString StatusEntriesModel::pathKey(const QString &path)
+{
+    return QDir::toNativeSeparators(QDir::cleanPath(path));
+}
+
 void StatusEntriesModel::refresh()
 {
     if (!m_directory.isEmpty())
     {
         readDirectory(m_directory, m_depth, true);
+    } else if (!m_roots.isEmpty()) {
+        //several roots are read in the background, the dialogs stay usable
+        scanDirectories(m_roots);
     } else {
         readFileList(m_fileList);
     }
-    reset();
 }
 
 svn::StatusPtr StatusEntriesModel::at(int row)
@@ -176,7 +551,96 @@ svn::StatusPtr StatusEntriesModel::at(int row)
     return m_statusEntries.at(row);
 }
 
-QPixmap StatusEntriesModel::statusPixmap(svn::StatusPtr status) const
+bool StatusEntriesModel::isDir(int row) const
+{
+    return m_rowData.at(row).isDir;
+}
+
+qint64 StatusEntriesModel::fileSize(int row) const
+{
+    if (m_rowData.at(row).size < 0)
+        readFileInfo(row);
+    return m_rowData.at(row).size;
+}
+
+quint32 StatusEntriesModel::statusMask(int row) const
+{
+    return m_rowData.at(row).statusMask;
+}
+
+const QString &StatusEntriesModel::filterPath(int row) const
+{
+    return m_rowData.at(row).filterPath;
+}
+
+bool StatusEntriesModel::lessThan(int leftRow, int rightRow, int column, Qt::CaseSensitivity cs) const
+{
+    const svn::StatusPtr &left = m_statusEntries.at(leftRow);
+    const svn::StatusPtr &right = m_statusEntries.at(rightRow);
+
+    switch (column)
+    {
+        case 0: //FileName
+            return m_rowData.at(leftRow).fileName.compare(m_rowData.at(rightRow).fileName, cs) < 0;
+        case 1: //Text-Status
+            return m_statusStrings.value(left->textStatus()).compare(m_statusStrings.value(right->textStatus()), cs) < 0;
+        case 2: //Property-Status
+            return m_statusStrings.value(left->propStatus()).compare(m_statusStrings.value(right->propStatus()), cs) < 0;
+        case 3: //Revision
+            //unversioned entries have no revision and sort first
+            return (left->isVersioned() ? long(left->entry().cmtRev()) : -1) <
+                   (right->isVersioned() ? long(right->entry().cmtRev()) : -1);
+        case 4: //Author
+            return left->entry().cmtAuthor().compare(right->entry().cmtAuthor(), cs) < 0;
+        default:
+            return leftRow < rightRow;
+    }
+}
+
+StatusEntriesModel::RowData StatusEntriesModel::rowData(const svn::StatusPtr status,
+                                                        const QSvnClientStatusAction::FileInfo *info) const
+{
+    RowData result;
+    if (!status->isVersioned() ||  //return path for unversioned Files
+         m_depth > svn::DepthFiles)
+        result.fileName = QDir::toNativeSeparators(status->path()).remove(0, m_directory.size());
+    else
+        result.fileName = status->entry().name();
+    result.filterPath = QDir::fromNativeSeparators(status->path()) + "/";
+    result.icon = statusIcon(status);
+
+    result.statusMask = (1 << status->textStatus()) | (1 << status->propStatus());
+
+    //the scan stats in its worker thread, else the size is read on the first use
+    if (info)
+    {
+        result.isDir = info->isDir;
+        result.size = info->size;
+    }
+    else
+    {
+        //unversioned paths have no entry to tell the kind
+        result.isDir = status->isVersioned() ? (status->entry().kind() == svn_node_dir)
+                                             : QFileInfo(status->path()).isDir();
+        result.size = -1;
+    }
+    return result;
+}
+
+void StatusEntriesModel::readFileInfo(int row) const
+{
+    QFileInfo fileInfo(m_statusEntries.at(row)->path());
+    m_rowData[row].size = fileInfo.size();
+}
+
+void StatusEntriesModel::updateRowData()
+{
+    m_rowData.resize(m_statusEntries.count());
+    for (int row = 0; row < m_statusEntries.count(); ++row)
+        m_rowData[row] = rowData(m_statusEntries.at(row));
+}
+
+StatusEntriesModel::StatusIcon StatusEntriesModel::statusIcon(const svn::StatusPtr status)
 {
     svn_wc_status_kind _status = status->textStatus();
     if (_status == svn_wc_status_normal)
@@ -185,29 +649,46 @@ QPixmap StatusEntriesModel::statusPixmap(svn::StatusPtr status) const
     switch (_status)
     {
         case svn_wc_status_unversioned:
-            return QPixmap(":/images/unknownfile.png");
+            return IconUnknown;
             break;
         case svn_wc_status_added:
-            return QPixmap(":/images/addedfile.png");
+            return IconAdded;
             break;
         case svn_wc_status_missing:
-            return QPixmap(":/images/missingfile.png");
+            return IconMissing;
             break;
         case svn_wc_status_deleted:
         case svn_wc_status_replaced:
         case svn_wc_status_modified:
         case svn_wc_status_merged:
-            return QPixmap(":/images/modifiedfile.png");
+            return IconModified;
             break;
         case svn_wc_status_conflicted:
-            return QPixmap(":/images/conflictedfile.png");
+            return IconConflicted;
             break;
         default:
-            return QPixmap(":/images/file.png");
+            return IconFile;
             break;
     }
 }
 
+const QVector<QPixmap> &StatusEntriesModel::statusPixmaps()
+{
+    //loaded once and shared by all rows and models
+    static QVector<QPixmap> pixmaps;
+    if (pixmaps.isEmpty())
+    {
+        pixmaps.resize(IconCount);
+        pixmaps[IconFile] = QPixmap(":/images/file.png");
+        pixmaps[IconUnknown] = QPixmap(":/images/unknownfile.png");
+        pixmaps[IconAdded] = QPixmap(":/images/addedfile.png");
+        pixmaps[IconMissing] = QPixmap(":/images/missingfile.png");
+        pixmaps[IconModified] = QPixmap(":/images/modifiedfile.png");
+        pixmaps[IconConflicted] = QPixmap(":/images/conflictedfile.png");
+    }
+    return pixmaps;
+}
+
 QString StatusEntriesModel::statusString(svn_wc_status_kind status) const
 {
     switch (status)
@@ -246,12 +727,12 @@ QString StatusEntriesModel::statusString(svn_wc_status_kind status) const
 }
 
 #if defined Q_WS_WIN32
-void StatusEntriesModel::checkCaseSensitivity()
+void StatusEntriesModel::checkCaseSensitivity(svn::StatusEntries &entries)
 {
     QFileInfo _fileInfo;
     svn::StatusPtr _status, __status;
 
-    foreach(_status, m_statusEntries)
+    foreach(_status, entries)
     {
         if (_status->textStatus() == svn_wc_status_missing)
         {
@@ -259,18 +740,18 @@ void StatusEntriesModel::checkCaseSensitivity()
             if (_fileInfo.exists())
             {
                 //remove unversioned file that match to the missing one
-                foreach(__status, m_statusEntries)
+                foreach(__status, entries)
                 {
                     if (__status->path().toLower() == _status->path().toLower())
-                        m_statusEntries.removeOne(__status);
+                        entries.removeOne(__status);
                 }
                 //remove missing file from list
-                m_statusEntries.removeOne(_status);
+                entries.removeOne(_status);
                 //rename missing file
                 if (QFile::rename(_fileInfo.absoluteFilePath(), _fileInfo.absoluteFilePath() + "_"))
                     QFile::rename(_fileInfo.absoluteFilePath() + "_", _status->path());
                 //add renamed file to the list
-                m_statusEntries.append(SvnClient::instance()->singleStatus(_status->path()));
+                entries.append(SvnClient::instance()->singleStatus(_status->path()));
             }
         }
     }
@@ -23,12 +23,17 @@
 
 //QSvn
 #include "qarfilesystemwatcher.h"
+#include "qsvnactions/qsvnclientstatusaction.h"
 
 //SvnQt
 #include "svnqt/client.hpp"
 
 //Qt
 #include <QAbstractTableModel>
+#include <QHash>
+#include <QPixmap>
+#include <QSet>
+#include <QVector>
 
 
 class StatusEntriesModel : public QAbstractTableModel
@@ -46,23 +51,101 @@ class StatusEntriesModel : public QAbstractTableModel
 
         void readDirectory(QString directory, svn::Depth depth, const bool force);
         void readFileList(QStringList fileList);
+        /**
+         * Read the status of directories in the background. Every directory itself
+         * is read first, then every versioned subdirectory on its own, so the rows
+         * appear part by part. Nested directories are read only once.
+         * scanStarted() is emitted before the old rows are dropped, scanFinished() at the end.
+         */
+        void scanDirectories(const QStringList &directories);
+        void cancelScan();
+        bool isScanning() const;
+        /**
+         * Read the status of some changed paths again and update only their rows.
+         * Paths outside the current directory are skipped.
+         */
+        void updatePaths(const QStringList &paths);
         void refresh();
 
         svn::StatusPtr at(int row);
+        QStringList rootDirectories() const;
+
+        /**
+         * Remove duplicates and paths below other paths of the list.
+         */
+        static QStringList collapsePaths(const QStringList &paths);
+
+        //values of the snapshot, the size is read on first use unless the scan has delivered it
+        bool isDir(int row) const;
+        qint64 fileSize(int row) const;
+        quint32 statusMask(int row) const; //bit (1 << kind) for text and property status
+        const QString &filterPath(int row) const; //path with '/' separators and a trailing '/'
+        bool lessThan(int leftRow, int rightRow, int column, Qt::CaseSensitivity cs) const;
     signals:
         void beginUpdate();
         void endUpdate();
+        void statusRead(const QString &directory, const svn::StatusEntries &entries);
+        void statusChanged(const QStringList &paths, const svn::StatusEntries &entries);
+        void scanStarted();
+        void scanProgress(int done, int total);
+        void scanFinished();
+    private slots:
+        void onScanActionFinished();
     private:
         svn::StatusEntries m_statusEntries;
         QString m_directory;
         QStringList m_fileList;
         svn::Depth m_depth;
+        QHash<QString, int> m_rows; //row of every path in m_statusEntries
+        QStringList m_roots; //directories of the last scan
+        QSet<QString> m_scanRoots; //keys of the paths read first
+        QHash<QSvnClientStatusAction*, int> m_scanJobs; //running and queued actions of a scan
+        int m_scanDone;
+        int m_scanTotal;
+
+        enum StatusIcon
+        {
+            IconFile = 0,
+            IconUnknown,
+            IconAdded,
+            IconMissing,
+            IconModified,
+            IconConflicted,
+            IconCount
+        };
+
+        //everything data() needs, computed once per row of a snapshot
+        struct RowData
+        {
+            QString fileName;
+            QString filterPath;
+            quint8 icon;
+            bool isDir;
+            qint64 size; //-1 until it is read
+            quint32 statusMask;
+        };
+        mutable QVector<RowData> m_rowData;
+        QStringList m_statusStrings; //translated names by svn_wc_status_kind
+
+        RowData rowData(const svn::StatusPtr status,
+                        const QSvnClientStatusAction::FileInfo *info = 0) const;
+        void readFileInfo(int row) const;
+        void updateRowData();
+
+        void updateRowIndex(int from = 0);
+        void applyEntries(const svn::StatusEntries &entries);
+        void upsertEntries(const svn::StatusEntries &entries,
+                           const QHash<QString, QSvnClientStatusAction::FileInfo> &infos);
+        void enqueueScan(const QString &path, svn::Depth depth);
+        static bool isSameStatus(const svn::StatusPtr status1, const svn::StatusPtr status2);
+        static QString pathKey(const QString &path);
 
-        QPixmap statusPixmap(svn::StatusPtr status) const;
+        static StatusIcon statusIcon(const svn::StatusPtr status);
+        static const QVector<QPixmap> &statusPixmaps();
         QString statusString(svn_wc_status_kind status) const;
 
 #if defined Q_WS_WIN32
-        void checkCaseSensitivity();
+        void checkCaseSensitivity(svn::StatusEntries &entries);
 #endif
 };
 
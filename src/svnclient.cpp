@@ -25,6 +25,7 @@
 #include "statustext.h"
 #include "svnclient.h"
 #include "svnclient.moc"
+#include "qsvnactions/qsvnclientstatusaction.h"
 
 //SvnCpp
 #include "svnqt/client.hpp"
@@ -42,6 +43,9 @@
 #include <QtGui>
 
 
+//directories with less targets are read with one status call per target
+#define MIN_TARGETS_PER_DIRECTORY 8
+
 //make SvnClient a singleton
 SvnClient* SvnClient::m_instance = 0;
 
@@ -102,6 +106,112 @@ svn::StatusEntries SvnClient::status(const QString& path,
     }
 }
 
+svn::StatusEntries SvnClient::status(const QStringList &targets)
+{
+    //group the targets by their parent directory
+    QStringList keys;
+    QSet<QString> keySet;
+    QHash<QString, QStringList> groups;
+    foreach (QString target, targets)
+    {
+        if (!QFile::exists(target))
+            continue;
+        QString key = QDir::toNativeSeparators(QDir::cleanPath(QFileInfo(target).absoluteFilePath()));
+        if (keySet.contains(key))
+            continue;
+        keySet << key;
+        keys << key;
+        groups[QFileInfo(key).path()] << key;
+    }
+
+    //one shallow status for crowded directories, single ones for the rest
+    QStringList directories;
+    QStringList singleTargets;
+    QHashIterator<QString, QStringList> it(groups);
+    while (it.hasNext())
+    {
+        it.next();
+        if (it.value().count() >= MIN_TARGETS_PER_DIRECTORY)
+            directories << it.key();
+        else
+            singleTargets << it.value();
+    }
+
+    QList<QSvnClientStatusAction*> actions;
+    actions << startStatus(directories, svn::DepthImmediates, false);
+    actions << startStatus(singleTargets, svn::DepthEmpty, true);
+
+    QHash<QString, svn::StatusPtr> statusHash;
+    foreach (svn::StatusPtr status, waitForStatus(actions))
+        statusHash.insert(QDir::toNativeSeparators(QDir::cleanPath(status->path())), status);
+
+    //a parent outside of a working copy fails, e.g. for sibling roots or externals
+    QStringList missingTargets;
+    foreach (QString directory, directories)
+    {
+        foreach (QString target, groups.value(directory))
+        {
+            if (!statusHash.contains(target))
+                missingTargets << target;
+        }
+    }
+    if (!missingTargets.isEmpty())
+    {
+        foreach (svn::StatusPtr status, waitForStatus(startStatus(missingTargets, svn::DepthEmpty, true)))
+            statusHash.insert(QDir::toNativeSeparators(QDir::cleanPath(status->path())), status);
+    }
+
+    //keep only the targets, a directory status contains all its children
+    svn::StatusEntries entries;
+    foreach (QString key, keys)
+    {
+        if (statusHash.contains(key))
+            entries.append(statusHash.value(key));
+    }
+    return entries;
+}
+
+QList<QSvnClientStatusAction*> SvnClient::startStatus(const QStringList &paths, svn::Depth depth,
+                                                      bool reportErrors)
+{
+    int threads = qMax(1, QThread::idealThreadCount());
+    QList<QSvnClientStatusAction*> actions;
+    for (int i = 0; i < threads && i < paths.count(); ++i)
+    {
+        QStringList bucket;
+        for (int j = i; j < paths.count(); j += threads)
+            bucket << paths.at(j);
+
+        QSvnClientStatusAction *action = new QSvnClientStatusAction(0, bucket, depth, true);
+        //the errors are queued and shown once the gui thread is back in its event loop
+        if (reportErrors)
+            connect(action, SIGNAL(notify(QString, QString)), this, SLOT(onStatusNotify(QString, QString)),
+                    Qt::QueuedConnection);
+        //the gui thread blocks on them, so they don't wait for a slot of the scheduler behind long jobs
+        action->start();
+        actions << action;
+    }
+    return actions;
+}
+
+svn::StatusEntries SvnClient::waitForStatus(const QList<QSvnClientStatusAction*> &actions)
+{
+    //no nested event loop, slots calling status() again can't run in between
+    svn::StatusEntries entries;
+    foreach (QSvnClientStatusAction *action, actions)
+    {
+        action->wait();
+        entries << action->statusEntries();
+        delete action;
+    }
+    return entries;
+}
+
+void SvnClient::onStatusNotify(QString action, QString message)
+{
+    StatusText::out(message);
+}
+
 svn::StatusPtr SvnClient::singleStatus(const QString &path)
 {
     listener->setVerbose(false);
@@ -264,24 +374,10 @@ bool SvnClient::commit(const QStringList &commitList, const QString &logMessage)
     try
     {
         svn::Targets targets(commitList);
-        svn::Depth _depth = svn::DepthFiles;
-        foreach(QString _path, commitList)
-        {
-            QFileInfo _fileInfo(_path);
-            if (_fileInfo.isDir())
-            {
-                svn::StatusPtr _status = singleStatus(_path);
-                if (_status->textStatus() == svn_wc_status_deleted)
-                {
-                    _depth = svn::DepthInfinity;
-                    break;
-                }
-            }
-        }
         svn::CommitParameter commitParameter;
         commitParameter
                 .targets(targets)
-                .depth(_depth)
+                .depth(commitDepth(commitList))
                 .message(logMessage);
         svnClient->commit(commitParameter);
         completedMessage(commitList.at(0));
@@ -294,6 +390,21 @@ bool SvnClient::commit(const QStringList &commitList, const QString &logMessage)
     return true;
 }
 
+svn::Depth SvnClient::commitDepth(const QStringList &commitList)
+{
+    foreach(QString _path, commitList)
+    {
+        QFileInfo _fileInfo(_path);
+        if (_fileInfo.isDir())
+        {
+            svn::StatusPtr _status = singleStatus(_path);
+            if (_status->textStatus() == svn_wc_status_deleted)
+                return svn::DepthInfinity;
+        }
+    }
+    return svn::DepthFiles;
+}
+
 bool SvnClient::remove(const QStringList &removeList)
 {
     if (removeList.isEmpty())
@@ -460,6 +571,11 @@ void SvnClient::completedMessage(const QString &path)
         StatusText::out(tr("Completed\n"));
 }
 
+QStringList SvnClient::takeTouchedPaths()
+{
+    return listener->takeTouchedPaths();
+}
+
 void SvnClient::setCancel()
 {
     listener->setCancel(true);
@@ -548,27 +664,33 @@ bool SvnClient::propSet(const svn::PropertiesMap propMap,
                         svn::Depth depth,
                         const svn::Revision &revision)
 {
-    bool result = true;
-    //remove all exist properties
+    //old properties of the path itself
+    svn::PropertiesMap _oldPropMap;
     svn::PathPropertiesMapListPtr _propList;
     _propList = propList(path, revision, revision);
-    if(!_propList->isEmpty())
+    if (_propList && !_propList->isEmpty())
+        _oldPropMap = _propList->at(0).second;
+
+    //only properties that are gone are removed
+    bool result = true;
+    QMapIterator<QString, QString> _oldIter(_oldPropMap);
+    while (_oldIter.hasNext())
     {
-        svn::PathPropertiesMapEntry entry = _propList->at(0);
-        svn::PropertiesMap _oldPropMap = entry.second;
-        QMapIterator<QString, QString> _oldIter(_oldPropMap);
-        while (_oldIter.hasNext())
-        {
-            _oldIter.next();
+        _oldIter.next();
+        if (!propMap.contains(_oldIter.key()))
             result = result && propDel(_oldIter.key(), path, svn::DepthEmpty, revision);
-        }
     }
 
-    //write new properties
+    //only new and changed properties are written, below path they may differ,
+    //so with a depth all of them are written
     QMapIterator<QString, QString> _iter(propMap);
     while (_iter.hasNext())
     {
         _iter.next();
+        if ((depth == svn::DepthEmpty) &&
+            _oldPropMap.contains(_iter.key()) &&
+            (_oldPropMap.value(_iter.key()) == _iter.value()))
+            continue;
         result = result && propSet(_iter.key(), _iter.value(), path, depth, revision);
     }
     return result;
@@ -687,6 +809,58 @@ bool SvnClient::merge(const QString &fromUrl, const svn::Revision &fromRevision,
     }
 }
 
+bool SvnClient::merge(const QString &url, const svn::RevisionRanges &revisionRanges,
+                      const QString &wcPath, bool force, bool recurse,
+                      bool notice_ancestry, bool dry_run)
+{
+    listener->setVerbose(true);
+
+    svn::MergeParameter mergeParameter;
+    mergeParameter
+            .revisions(revisionRanges)
+            .path1(url)
+            .peg(svn::Revision::HEAD)
+            .localPath(wcPath)
+            .depth(recurse?svn::DepthInfinity:svn::DepthFiles)
+            .notice_ancestry(notice_ancestry)
+            .force(force)
+            .dry_run(dry_run);
+    try
+    {
+        svnClient->merge_peg(mergeParameter);
+        return true;
+    }
+    catch (svn::ClientException e)
+    {
+        StatusText::out(e.msg());
+        return false;
+    }
+}
+
+svn::RevisionRanges SvnClient::revisionRanges(QList<svn_revnum_t> revisions, bool reverse)
+{
+    qSort(revisions);
+
+    //a merge of the revisions N to M is the range N-1:M, a revert M:N-1
+    svn::RevisionRanges ranges;
+    int first = 0;
+    while (first < revisions.count())
+    {
+        int last = first;
+        while (last + 1 < revisions.count() && revisions.at(last + 1) <= revisions.at(last) + 1)
+            ++last;
+
+        if (reverse)
+            ranges.prepend(svn::RevisionRange(svn::Revision(revisions.at(last)),
+                                              svn::Revision(revisions.at(first) - 1)));
+        else
+            ranges.append(svn::RevisionRange(svn::Revision(revisions.at(first) - 1),
+                                             svn::Revision(revisions.at(last))));
+        first = last + 1;
+    }
+    return ranges;
+}
+
 const QString SvnClient::getUUID(const QString &path)
 {
     svn::InfoEntries infoEntries = svnClient->info(path, svn::DepthEmpty, svn::Revision::UNDEFINED, svn::Revision::UNDEFINED);
@@ -696,6 +870,23 @@ const QString SvnClient::getUUID(const QString &path)
         return QString();
 }
 
+QString SvnClient::repositoryHost(const QString &path)
+{
+    listener->setVerbose(false);
+    try
+    {
+        svn::InfoEntries infoEntries = svnClient->info(path, svn::DepthEmpty, svn::Revision::UNDEFINED, svn::Revision::UNDEFINED);
+        if (!infoEntries.isEmpty())
+            return QUrl(infoEntries.at(0).url()).host();
+    }
+    catch (svn::ClientException e)
+    {
+        //without a server key the action is only limited per working copy
+        StatusText::out(e.msg());
+    }
+    return QString();
+}
+
 const QString SvnClient::getSvnActionName(const SvnAction action)
 {
     switch (action)
@@ -24,11 +24,13 @@
 //QSvn
 
 class Listener;
+class QSvnClientStatusAction;
 
 //SvnCpp
 #include "svnqt/client.hpp"
 
 //Qt
+#include <QList>
 #include <QObject>
 
 
@@ -73,6 +75,12 @@ class SvnClient : public QObject
                                   bool detailed_remote = false,
                                   const bool hide_externals = false);
 
+        /**
+         * Return StatusEntries for a list of files and directories, in the order of targets.
+         * Targets that don't exist are skipped. Targets are grouped by their parent
+         * directory and the groups are read in parallel.
+         */
+        svn::StatusEntries status(const QStringList &targets);
         svn::StatusPtr singleStatus(const QString &path);
 
         /**
@@ -89,6 +97,8 @@ class SvnClient : public QObject
         bool revert(const QStringList &revertList, const bool verbose = true);
         bool revert(const QString fileName, const bool verbose = true);
         bool commit(const QStringList &commitList, const QString &logMessage);
+        svn::Depth commitDepth(const QStringList &commitList); //deleted directories need DepthInfinity
+        void completedMessage(const QString &path);
         bool remove(const QStringList &removeList);
         bool diff(const QString &fileFrom, const QString &fileTo, const svn::Revision &revisionFrom, const svn::Revision &revisionTo);
         bool diffBASEvsWORKING(const QString &file);
@@ -105,6 +115,18 @@ class SvnClient : public QObject
                    const QString &wcPath, bool force, bool recurse,
                    bool notice_ancestry = false,
                    bool dry_run = false);
+        /**
+         * Merge several revision ranges of one url in one pass.
+         */
+        bool merge(const QString &url, const svn::RevisionRanges &revisionRanges,
+                   const QString &wcPath, bool force, bool recurse,
+                   bool notice_ancestry = false,
+                   bool dry_run = false);
+        /**
+         * Join consecutive revisions to ranges for a merge of these revisions,
+         * or, with reverse, for a revert of them starting with the youngest.
+         */
+        static svn::RevisionRanges revisionRanges(QList<svn_revnum_t> revisions, bool reverse = false);
 
         bool log(const QString &path,
                                      const svn::Revision &revisionStart,
@@ -147,6 +169,14 @@ class SvnClient : public QObject
 
         //Helper
         const QString getUUID(const QString &path);
+        /**
+         * Host of the repository of a working copy path, the server key for QSvnActionScheduler.
+         */
+        QString repositoryHost(const QString &path);
+        /**
+         * Paths changed in the working copy by the actions since the last call.
+         */
+        QStringList takeTouchedPaths();
         const QString getSvnActionName(const SvnAction action);
 
     public slots:
@@ -164,9 +194,15 @@ class SvnClient : public QObject
         Listener *listener;
         bool m_InProgress; //true, if svn update is running
 
-        void completedMessage(const QString &path);
         QString getFileRevisionPath(const QString &file, const svn::Revision &revision);
         QString m_lastErrorMessage;
+
+        QList<QSvnClientStatusAction*> startStatus(const QStringList &paths, svn::Depth depth,
+                                                   bool reportErrors);
+        svn::StatusEntries waitForStatus(const QList<QSvnClientStatusAction*> &actions);
+
+    private slots:
+        void onStatusNotify(QString action, QString message);
 };
 
 #endif
@@ -0,0 +1,206 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+//QSvn
+#include "wcdirectoryloader.h"
+#include "wcdirectoryloader.moc"
+
+//SvnCpp
+#include "svnqt/wc.hpp"
+
+//Qt
+#include <QDir>
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QTime>
+
+
+//a batch is reported after this number of directories or milliseconds
+#define BATCH_SIZE 64
+#define BATCH_INTERVAL 200
+
+WcDirectoryLoader::WcDirectoryLoader(QObject *parent)
+        : QThread(parent)
+{
+    m_stop = false;
+    m_nextToken = 1;
+}
+
+WcDirectoryLoader::~WcDirectoryLoader()
+{
+    stop();
+    wait();
+}
+
+int WcDirectoryLoader::load(const QString &dir)
+{
+    //a running listing of dir becomes stale and stops, dir is listed again
+    QMutexLocker locker(&m_mutex);
+    int token = m_nextToken++;
+    m_tokens.insert(dir, token);
+    if (!m_loadQueue.contains(dir))
+        m_loadQueue.append(dir);
+    m_waitCondition.wakeOne();
+    return token;
+}
+
+void WcDirectoryLoader::checkWc(const QString &dir)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_checkQueue.contains(dir))
+        m_checkQueue.append(dir);
+    m_waitCondition.wakeOne();
+}
+
+void WcDirectoryLoader::cancel(const QString &dir)
+{
+    QMutexLocker locker(&m_mutex);
+    m_loadQueue.removeAll(dir);
+    m_tokens.remove(dir);
+}
+
+void WcDirectoryLoader::invalidate(const QString &dir)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(dir);
+}
+
+void WcDirectoryLoader::stop()
+{
+    QMutexLocker locker(&m_mutex);
+    m_stop = true;
+    m_waitCondition.wakeOne();
+}
+
+bool WcDirectoryLoader::isCanceled(const QString &dir, int token)
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stop || m_tokens.value(dir, 0) != token;
+}
+
+void WcDirectoryLoader::run()
+{
+    forever
+    {
+        QString dir;
+        int token = 0;
+        bool check = false;
+
+        m_mutex.lock();
+        while (!m_stop && m_loadQueue.isEmpty() && m_checkQueue.isEmpty())
+            m_waitCondition.wait(&m_mutex);
+        if (m_stop)
+        {
+            m_mutex.unlock();
+            return;
+        }
+        //checks are cheap and let the root items show their icon early
+        if (!m_checkQueue.isEmpty())
+        {
+            dir = m_checkQueue.takeFirst();
+            check = true;
+        }
+        else
+        {
+            dir = m_loadQueue.takeFirst();
+            token = m_tokens.value(dir, 0);
+        }
+        m_mutex.unlock();
+
+        if (check)
+            emit wcChecked(dir, svn::Wc::checkWc(dir.toLocal8Bit()), hasSubdirs(dir));
+        else
+            listDirectory(dir, token);
+    }
+}
+
+void WcDirectoryLoader::listDirectory(const QString &dir, int token)
+{
+    QDateTime modified = QFileInfo(dir).lastModified();
+
+    m_mutex.lock();
+    if (m_cache.contains(dir) && m_cache.value(dir).modified == modified)
+    {
+        CacheEntry entry = m_cache.value(dir);
+        m_mutex.unlock();
+        emit dirsLoaded(dir, token, entry.names, entry.wcNames, entry.leafNames, true);
+        return;
+    }
+    m_mutex.unlock();
+
+    CacheEntry entry;
+    entry.modified = modified;
+
+    QStringList names;
+    QStringList wcNames;
+    QStringList leafNames;
+    QTime batchTime;
+    batchTime.start();
+
+    foreach (QString name, QDir(dir).entryList(QDir::AllDirs | QDir::NoDotAndDotDot))
+    {
+        if (name.startsWith('.'))
+            continue;
+        if (isCanceled(dir, token))
+            return;
+
+        names << name;
+        entry.names << name;
+        QString path = dir + QDir::separator() + name;
+        if (svn::Wc::checkWc(path.toLocal8Bit()))
+        {
+            wcNames << name;
+            entry.wcNames << name;
+        }
+        if (!hasSubdirs(path))
+        {
+            leafNames << name;
+            entry.leafNames << name;
+        }
+
+        if (names.count() >= BATCH_SIZE || batchTime.elapsed() >= BATCH_INTERVAL)
+        {
+            emit dirsLoaded(dir, token, names, wcNames, leafNames, false);
+            names.clear();
+            wcNames.clear();
+            leafNames.clear();
+            batchTime.restart();
+        }
+    }
+
+    m_mutex.lock();
+    m_cache.insert(dir, entry);
+    m_mutex.unlock();
+
+    emit dirsLoaded(dir, token, names, wcNames, leafNames, true);
+}
+
+bool WcDirectoryLoader::hasSubdirs(const QString &dir)
+{
+    //stop at the first one, hidden directories are not listed
+    QDirIterator it(dir, QDir::Dirs | QDir::NoDotAndDotDot);
+    while (it.hasNext())
+    {
+        it.next();
+        if (!it.fileName().startsWith('.'))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,105 @@
+/********************************************************************************
+ *   This file is part of QSvn Project http://www.anrichter.net/projects/qsvn   *
+ *   Copyright (c) 2004-2010 Andreas Richter <ar@anrichter.net>                 *
+ *                                                                              *
+ *   This program is free software; you can redistribute it and/or modify       *
+ *   it under the terms of the GNU General Public License Version 2             *
+ *   as published by the Free Software Foundation.                              *
+ *                                                                              *
+ *   This program is distributed in the hope that it will be useful,            *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of             *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the              *
+ *   GNU General Public License for more details.                               *
+ *                                                                              *
+ *   You should have received a copy of the GNU General Public License          *
+ *   along with this program; if not, write to the                              *
+ *   Free Software Foundation, Inc.,                                            *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.                  *
+ *                                                                              *
+ *******************************************************************************/
+
+#ifndef WCDIRECTORYLOADER_H
+#define WCDIRECTORYLOADER_H
+
+//Qt
+#include <QDateTime>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+
+/**
+Lists the subdirectories of a directory and checks each of them for a
+working copy and for own subdirectories in a background thread. Results
+are reported in batches and cached until the modification time of the
+directory changes.
+*/
+
+class WcDirectoryLoader : public QThread
+{
+        Q_OBJECT
+
+    public:
+        WcDirectoryLoader(QObject *parent = 0);
+        ~WcDirectoryLoader();
+
+        /**
+         * Queue a directory for listing. The subdirectories are reported with dirsLoaded().
+         * @return Token of this request, a later load() or cancel() of dir makes it stale.
+         */
+        int load(const QString &dir);
+        /**
+         * Queue a directory for a working copy and subdirectory check. The result is reported with wcChecked().
+         */
+        void checkWc(const QString &dir);
+        /**
+         * Drop a queued or running listing of a directory.
+         */
+        void cancel(const QString &dir);
+        /**
+         * Forget the cached listing of a directory.
+         */
+        void invalidate(const QString &dir);
+        void stop();
+
+    signals:
+        /**
+         * @param token Token returned by load(), batches of stale requests have to be dropped.
+         * @param names Subdirectories found since the last batch.
+         * @param wcNames The part of names which are working copies.
+         * @param leafNames The part of names without subdirectories.
+         * @param complete true for the last batch of dir.
+         */
+        void dirsLoaded(const QString &dir, int token, const QStringList &names,
+                        const QStringList &wcNames, const QStringList &leafNames, bool complete);
+        void wcChecked(const QString &dir, bool isWc, bool hasSubdirs);
+
+    protected:
+        void run();
+
+    private:
+        struct CacheEntry
+        {
+            QDateTime modified;
+            QStringList names;
+            QStringList wcNames;
+            QStringList leafNames;
+        };
+
+        QMutex m_mutex;
+        QWaitCondition m_waitCondition;
+        QStringList m_loadQueue;
+        QStringList m_checkQueue;
+        QHash<QString, int> m_tokens; //token of the current request of a directory
+        int m_nextToken;
+        QHash<QString, CacheEntry> m_cache;
+        bool m_stop;
+
+        void listDirectory(const QString &dir, int token);
+        bool isCanceled(const QString &dir, int token);
+        static bool hasSubdirs(const QString &dir);
+};
+
+#endif
@@ -20,11 +20,11 @@
 
 //QSvn
 #include "config.h"
+#include "wcdirectoryloader.h"
 #include "wcmodel.h"
 #include "wcmodel.moc"
-
-//SvnCpp
-#include "svnqt/wc.hpp"
+#include "qsvnactions/qsvnactionscheduler.h"
+#include "qsvnactions/qsvnclientstatusaction.h"
 
 //Qt
 #include <QtGui>
@@ -34,12 +34,25 @@ WcModel::WcModel(QObject *parent)
         : QStandardItemModel(parent)
 {
     setHorizontalHeaderLabels(QStringList("Working Copy"));
+
+    m_loader = new WcDirectoryLoader(this);
+    connect(m_loader, SIGNAL(dirsLoaded(const QString &, int, const QStringList &, const QStringList &, const QStringList &, bool)),
+            this, SLOT(onDirsLoaded(const QString &, int, const QStringList &, const QStringList &, const QStringList &, bool)));
+    connect(m_loader, SIGNAL(wcChecked(const QString &, bool, bool)),
+            this, SLOT(onWcChecked(const QString &, bool, bool)));
+    m_loader->start(QThread::LowPriority);
+
+    connect(this, SIGNAL(rowsAboutToBeRemoved(const QModelIndex &, int, int)),
+            this, SLOT(onRowsAboutToBeRemoved(const QModelIndex &, int, int)));
+
     loadWcList();
 }
 
 WcModel::~WcModel()
 {
     saveWcList();
+    m_loader->stop();
+    m_loader->wait();
 }
 
 bool WcModel::hasChildren(const QModelIndex &parent) const
@@ -47,19 +60,114 @@ bool WcModel::hasChildren(const QModelIndex &parent) const
     if (!parent.isValid())
         return true;
     else {
+        //a directory without subdirectories is marked as populated by the loader
         QStandardItem *_item = itemFromIndex(parent);
         if (!_item->data(PopulatedRole).toBool())
-            populate(_item);
+            return !_item->data(PathRole).toString().isEmpty();
         return _item->rowCount();
     }
 }
 
-void WcModel::populate(QStandardItem * parent) const
+bool WcModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+        return false;
+
+    QStandardItem *_item = itemFromIndex(parent);
+    return !_item->data(PathRole).toString().isEmpty() && !_item->data(PopulatedRole).toBool();
+}
+
+void WcModel::fetchMore(const QModelIndex &parent)
+{
+    if (canFetchMore(parent))
+        populate(itemFromIndex(parent));
+}
+
+void WcModel::populate(QStandardItem * parent)
+{
+    //a new listing replaces a running one, other items of the directory wait for it too
+    QString dir = parent->data(PathRole).toString();
+    QList<QStandardItem*> _items = itemsFromDirectory(dir);
+    if (!_items.contains(parent))
+        _items << parent;
+    foreach (QStandardItem *_item, _items)
+    {
+        if (_item != parent && !_item->data(LoadingRole).toBool())
+            continue;
+
+        _item->removeRows(0, _item->rowCount());
+
+        //placeholder until the first directories arrive
+        QStandardItem *_loading = new QStandardItem(tr("Loading..."));
+        _loading->setEnabled(false);
+        _loading->setSelectable(false);
+        _item->appendRow(_loading);
+
+        _item->setData(true, PopulatedRole);
+        _item->setData(true, LoadingRole);
+    }
+    m_loadTokens.insert(dir, m_loader->load(dir));
+}
+
+void WcModel::cancelLoad(QStandardItem *item)
 {
-    parent->removeRows(0, parent->rowCount());
-    foreach (QString _dir, QDir(parent->data(PathRole).toString()).entryList(QDir::AllDirs).filter(QRegExp("^[^.]")))
-        insertDir(_dir, parent, parent->rowCount());
-    parent->setData(true, PopulatedRole);
+    //other items of the directory may still wait for the listing
+    QString dir = item->data(PathRole).toString();
+    foreach (QStandardItem *_item, itemsFromDirectory(dir))
+    {
+        if (_item != item && _item->data(LoadingRole).toBool())
+            return;
+    }
+    m_loader->cancel(dir);
+    m_loadTokens.remove(dir);
+}
+
+void WcModel::onDirsLoaded(const QString &dir, int token, const QStringList &names,
+                           const QStringList &wcNames, const QStringList &leafNames, bool complete)
+{
+    //batches of a canceled or replaced listing may still be queued
+    if (m_loadTokens.value(dir, 0) != token)
+        return;
+    if (complete)
+        m_loadTokens.remove(dir);
+
+    foreach (QStandardItem *_item, itemsFromDirectory(dir))
+    {
+        if (!_item->data(LoadingRole).toBool())
+            continue;
+
+        //new directories go in front of the placeholder
+        foreach (QString _name, names)
+            insertDir(_name, _item, _item->rowCount() - 1, wcNames.contains(_name), !leafNames.contains(_name));
+
+        if (complete)
+        {
+            _item->removeRow(_item->rowCount() - 1);
+            _item->setData(false, LoadingRole);
+        }
+    }
+}
+
+void WcModel::onWcChecked(const QString &dir, bool isWc, bool hasSubdirs)
+{
+    bool changed = false;
+    foreach (QStandardItem *_item, itemsFromDirectory(dir))
+    {
+        _item->setData(isWc, WcRole);
+        updateIcon(_item);
+        if (!hasSubdirs && !_item->data(PopulatedRole).toBool())
+        {
+            _item->setData(true, PopulatedRole);
+            changed = true;
+        }
+    }
+
+    //the view asks hasChildren() only while it lays out the items
+    if (changed)
+    {
+        emit layoutAboutToBeChanged();
+        emit layoutChanged();
+    }
 }
 
 void WcModel::insertWc(QString dir)
@@ -71,22 +179,27 @@ void WcModel::insertWc(QString dir)
         if (dir > getPath(invisibleRootItem()->child(i)->index()))
             row = i + 1;
     }
-    insertDir(dir, invisibleRootItem(), row);
+    insertDir(dir, invisibleRootItem(), row, true);
+    m_loader->checkWc(dir);
+    scanStatus(dir);
 }
 
 void WcModel::removeWc(QString dir)
 {
-    foreach(QStandardItem* _item, findItems(dir))
+    //only favorites are removed, subdirectories stay in the tree
+    foreach(QStandardItem* _item, itemsFromDirectory(dir))
     {
-        removeRow(_item->row(), _item->index().parent());
+        if (_item->parent())
+            continue;
+        cancelLoad(_item);
+        removeRow(_item->row());
     }
-}
 
-void WcModel::updateWc(QString dir)
-{
-    QStandardItem *_item = itemFromDirectory(dir);
-    if (_item)
-        populate(_item->parent());
+    if (!itemFromDirectory(dir))
+    {
+        setStatus(dir, svn::StatusEntries());
+        m_statusRoots.remove(indexKey(dir));
+    }
 }
 
 QString WcModel::getPath(const QModelIndex &index) const
@@ -94,7 +207,7 @@ QString WcModel::getPath(const QModelIndex &index) const
     return itemFromIndex(index)->data(PathRole).toString();
 }
 
-void WcModel::insertDir(QString dir, QStandardItem * parent, int row) const
+QStandardItem* WcModel::insertDir(QString dir, QStandardItem * parent, int row, bool isWc, bool hasSubdirs)
 {
     QStandardItem *item = new QStandardItem();
 
@@ -104,23 +217,30 @@ void WcModel::insertDir(QString dir, QStandardItem * parent, int row) const
     if (parent != invisibleRootItem())
         dir = parent->data(PathRole).toString() + QDir::separator() + dir;
     item->setData(QDir::toNativeSeparators(dir), PathRole);
+    m_itemIndex.insert(indexKey(dir), item);
 
-    if (svn::Wc::checkWc(dir.toLocal8Bit()))
-        item->setIcon(QIcon(":/images/folder.png"));
-    else
-        item->setIcon(QIcon(":/images/unknownfolder.png"));
+    item->setData(isWc, WcRole);
+    //nothing to list, hasChildren() is false
+    item->setData(!hasSubdirs, PopulatedRole);
+    updateIcon(item);
 
     parent->insertRow(row, item);
+    return item;
 }
 
-void WcModel::saveWcList()
+QStringList WcModel::workingCopies() const
 {
     QStringList wcList;
 
     for (int i = 0; i < invisibleRootItem()->rowCount(); i++)
         wcList << invisibleRootItem()->child(i)->data(PathRole).toString();
 
-    Config::instance()->saveStringList("workingCopies", wcList);
+    return wcList;
+}
+
+void WcModel::saveWcList()
+{
+    Config::instance()->saveStringList("workingCopies", workingCopies());
 }
 
 void WcModel::loadWcList()
@@ -129,48 +249,360 @@ void WcModel::loadWcList()
     wcList.sort();
 
     foreach (QString wc, wcList)
-        insertDir(wc, invisibleRootItem(), invisibleRootItem()->rowCount());
+    {
+        insertDir(wc, invisibleRootItem(), invisibleRootItem()->rowCount(), true);
+        m_loader->checkWc(QDir::toNativeSeparators(wc));
+        scanStatus(wc);
+    }
 }
 
 void WcModel::doCollapse(const QModelIndex & index)
 {
-    itemFromIndex(index)->setData(false, PopulatedRole);
+    //the directory is listed again with the next expand
+    QStandardItem *_item = itemFromIndex(index);
+    cancelLoad(_item);
+    _item->removeRows(0, _item->rowCount());
+    _item->setData(false, PopulatedRole);
+    _item->setData(false, LoadingRole);
+}
+
+QString WcModel::indexKey(const QString &dir)
+{
+#ifdef Q_WS_WIN
+    return QDir::toNativeSeparators(QDir::cleanPath(dir)).toLower();
+#else
+    return QDir::toNativeSeparators(QDir::cleanPath(dir));
+#endif
+}
+
+QStandardItem * WcModel::itemFromDirectory(const QString dir) const
+{
+    return m_itemIndex.value(indexKey(dir), 0);
 }
 
-QStandardItem * WcModel::itemFromDirectory(const QString dir, const QStandardItem * parent)
+QList<QStandardItem*> WcModel::itemsFromDirectory(const QString dir) const
 {
-    if (parent)
+    return m_itemIndex.values(indexKey(dir));
+}
+
+void WcModel::unindexItem(QStandardItem *item)
+{
+    for (int i = 0; i < item->rowCount(); i++)
+        unindexItem(item->child(i));
+
+    QString path = item->data(PathRole).toString();
+    if (!path.isEmpty())
+        m_itemIndex.remove(indexKey(path), item);
+}
+
+void WcModel::onRowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
+{
+    QStandardItem *_parent = parent.isValid() ? itemFromIndex(parent) : invisibleRootItem();
+    for (int i = start; i <= end; i++)
+        unindexItem(_parent->child(i));
+}
+
+void WcModel::scanStatus(QString wc)
+{
+    wc = QDir::toNativeSeparators(QDir::cleanPath(wc));
+    m_statusRoots.insert(indexKey(wc));
+
+    QSvnClientStatusAction *action = new QSvnClientStatusAction(wc);
+    connect(action, SIGNAL(finished(QString)), this, SLOT(onStatusFinished(QString)));
+    connect(action, SIGNAL(finished()), action, SLOT(deleteLater()));
+    QSvnActionScheduler::instance()->enqueue(action, QSvnActionScheduler::Maintenance, QString(), wc,
+                                             QSvnActionScheduler::Shared);
+}
+
+void WcModel::invalidatePaths(const QStringList &paths)
+{
+    QStringList existingPaths;
+    foreach (QString path, paths)
     {
-        for (int i = 0; i < parent->rowCount(); i++)
+        QFileInfo fileInfo(path);
+        if (fileInfo.exists())
+            existingPaths << path;
+
+        if (fileInfo.exists() && fileInfo.isDir() && !itemFromDirectory(path))
         {
-            if (parent->child(i)->data(PathRole) == dir)
-                return parent->child(i);
+            //a new directory is shown in every listed parent, the grandparent knows it has one
+            m_loader->invalidate(fileInfo.path());
+            m_loader->invalidate(QFileInfo(fileInfo.path()).path());
+            foreach (QStandardItem *_parent, itemsFromDirectory(fileInfo.path()))
+            {
+                if (!_parent->data(PopulatedRole).toBool() || _parent->data(LoadingRole).toBool())
+                    continue;
+                int row = 0;
+                while (row < _parent->rowCount() &&
+                       _parent->child(row)->text().compare(fileInfo.fileName(), Qt::CaseInsensitive) < 0)
+                    ++row;
+                insertDir(fileInfo.fileName(), _parent, row, false);
+            }
         }
-        //search recursive
-        QStandardItem *_result;
-        for (int i = 0; i < parent->rowCount(); i++)
+        else if (!fileInfo.exists())
         {
-            _result = itemFromDirectory(dir, parent->child(i));
-            if (_result)
-                return _result;
+            //a removed directory vanishes, favorites stay in the tree
+            foreach (QStandardItem *_item, itemsFromDirectory(path))
+            {
+                if (!_item->parent())
+                    continue;
+                m_loader->invalidate(fileInfo.path());
+                m_loader->invalidate(QFileInfo(fileInfo.path()).path());
+                _item->parent()->removeRow(_item->row());
+            }
         }
     }
+
+    if (existingPaths.isEmpty())
+    {
+        updateStatus(paths, svn::StatusEntries());
+        return;
+    }
+
+    QSvnClientStatusAction *action = new QSvnClientStatusAction(0, existingPaths, svn::DepthEmpty);
+    m_pathUpdates.insert(action, paths);
+    connect(action, SIGNAL(finished()), this, SLOT(onPathStatusFinished()));
+    connect(action, SIGNAL(finished()), action, SLOT(deleteLater()));
+    //the touched paths are the ones the user looks at next
+    QSvnActionScheduler::instance()->enqueue(action, QSvnActionScheduler::Prefetch);
+}
+
+void WcModel::onPathStatusFinished()
+{
+    QSvnClientStatusAction *action = qobject_cast<QSvnClientStatusAction*>(sender());
+    if (!action || !m_pathUpdates.contains(action))
+        return;
+
+    //paths without an error are taken over, the others are reported as clean
+    updateStatus(m_pathUpdates.take(action), action->statusEntries());
+}
+
+void WcModel::onStatusFinished(QString wc)
+{
+    QSvnClientStatusAction *action = qobject_cast<QSvnClientStatusAction*>(sender());
+    if (action && m_statusRoots.contains(indexKey(wc)))
+        setStatus(wc, action->statusEntries());
+}
+
+void WcModel::setStatus(const QString &wc, const svn::StatusEntries &entries)
+{
+    QHash<QString, int> states;
+    QSet<QString> dirs;
+    foreach (svn::StatusPtr status, entries)
+    {
+        QString key = indexKey(status->path());
+        states.insert(key, dirtyState(status));
+        if (isDirectory(status))
+            dirs.insert(key);
+    }
+
+    //paths that were dirty before, but are not reported anymore
+    QString root = indexKey(wc);
+    QString rootPrefix = root + QDir::separator();
+    foreach (QString key, m_pathStates.keys())
+    {
+        if ((key == root || key.startsWith(rootPrefix)) && !states.contains(key))
+            setPathState(key, 0);
+    }
+
+    QHashIterator<QString, int> it(states);
+    while (it.hasNext())
+    {
+        it.next();
+        setPathState(it.key(), it.value(), dirs.contains(it.key()));
+    }
+}
+
+void WcModel::updateStatus(const QString &dir, const svn::StatusEntries &entries)
+{
+    QHash<QString, int> states;
+    QSet<QString> dirs;
+    foreach (svn::StatusPtr status, entries)
+    {
+        QString key = indexKey(status->path());
+        states.insert(key, dirtyState(status));
+        if (isDirectory(status))
+            dirs.insert(key);
+    }
+
+    //files which are not reported anymore are clean now
+    foreach (QString path, m_dirtyFiles.value(indexKey(dir)))
+    {
+        if (!states.contains(path))
+            setPathState(path, 0);
+    }
+
+    QHashIterator<QString, int> it(states);
+    while (it.hasNext())
+    {
+        it.next();
+        setPathState(it.key(), it.value(), dirs.contains(it.key()));
+    }
+}
+
+void WcModel::updateStatus(const QStringList &paths, const svn::StatusEntries &entries)
+{
+    QHash<QString, int> states;
+    foreach (QString path, paths)
+        states.insert(indexKey(path), 0);
+    foreach (svn::StatusPtr status, entries)
+        states.insert(indexKey(status->path()), dirtyState(status));
+
+    QHashIterator<QString, int> it(states);
+    while (it.hasNext())
+    {
+        it.next();
+        setPathState(it.key(), it.value());
+    }
+}
+
+void WcModel::setPathState(const QString &key, int state, bool isDir)
+{
+    //paths outside of the scanned working copies have no icon to show
+    if (!isUnderStatusRoot(key))
+        return;
+
+    QString parentKey = indexKey(QFileInfo(key).path());
+    if (state && !isDir)
+        m_dirtyFiles[parentKey].insert(key);
+    else if (m_dirtyFiles.contains(parentKey))
+    {
+        m_dirtyFiles[parentKey].remove(key);
+        if (m_dirtyFiles.value(parentKey).isEmpty())
+            m_dirtyFiles.remove(parentKey);
+    }
+
+    int oldState = m_pathStates.value(key, 0);
+    if (state == oldState)
+        return;
+
+    if (state)
+        m_pathStates.insert(key, state);
     else
+        m_pathStates.remove(key);
+
+    //propagate the difference up to the working copy root
+    int modified = bool(state & Modified) - bool(oldState & Modified);
+    int conflicted = bool(state & Conflicted) - bool(oldState & Conflicted);
+    int unversioned = bool(state & Unversioned) - bool(oldState & Unversioned);
+
+    QString dir = key;
+    forever
     {
-        for (int i = 0; i < rowCount(); i++)
-        {
-            if (item(i)->data(PathRole) == dir)
-                return item(i);
-        }
-        //search recursive
-        QStandardItem *_result;
-        for (int i = 0; i < rowCount(); i++)
+        DirtyCounts counts = m_dirtyCounts.value(dir);
+        counts.modified += modified;
+        counts.conflicted += conflicted;
+        counts.unversioned += unversioned;
+        if (counts.modified || counts.conflicted || counts.unversioned)
+            m_dirtyCounts.insert(dir, counts);
+        else
+            m_dirtyCounts.remove(dir);
+
+        foreach (QStandardItem *_item, m_itemIndex.values(dir))
+            updateIcon(_item);
+
+        QString parent = indexKey(QFileInfo(dir).path());
+        if (m_statusRoots.contains(dir) || parent == dir)
+            break;
+        dir = parent;
+    }
+}
+
+bool WcModel::isUnderStatusRoot(const QString &key) const
+{
+    foreach (QString root, m_statusRoots)
+    {
+        if (key == root || key.startsWith(root + QDir::separator()))
+            return true;
+    }
+    return false;
+}
+
+void WcModel::updateIcon(QStandardItem *item)
+{
+    DirtyCounts counts = m_dirtyCounts.value(indexKey(item->data(PathRole).toString()));
+
+    int state = 0;
+    if (counts.conflicted)
+        state = Conflicted;
+    else if (counts.modified)
+        state = Modified;
+    else if (counts.unversioned)
+        state = Unversioned;
+
+    item->setIcon(folderIcon(item->data(WcRole).toBool(), state));
+
+    if (state)
+        item->setToolTip(tr("%1 modified, %2 conflicted, %3 unversioned")
+                .arg(counts.modified)
+                .arg(counts.conflicted)
+                .arg(counts.unversioned));
+    else
+        item->setToolTip(QString());
+}
+
+int WcModel::dirtyState(const svn::StatusPtr status)
+{
+    int state = 0;
+    switch (status->textStatus())
+    {
+        case svn_wc_status_unversioned:
+            state |= Unversioned;
+            break;
+        case svn_wc_status_conflicted:
+            state |= Conflicted;
+            break;
+        case svn_wc_status_added:
+        case svn_wc_status_missing:
+        case svn_wc_status_deleted:
+        case svn_wc_status_replaced:
+        case svn_wc_status_modified:
+        case svn_wc_status_merged:
+            state |= Modified;
+            break;
+        default:
+            break;
+    }
+    if (status->propStatus() == svn_wc_status_conflicted)
+        state |= Conflicted;
+    else if (status->propStatus() == svn_wc_status_modified)
+        state |= Modified;
+    return state;
+}
+
+bool WcModel::isDirectory(const svn::StatusPtr status)
+{
+    //unversioned paths have no entry to tell
+    if (status->isVersioned())
+        return status->entry().kind() == svn_node_dir;
+    return QFileInfo(status->path()).isDir();
+}
+
+QIcon WcModel::folderIcon(bool isWc, int state)
+{
+    static QHash<int, QIcon> icons;
+
+    int key = state * 2 + (isWc ? 1 : 0);
+    if (!icons.contains(key))
+    {
+        QPixmap folder(isWc ? ":/images/folder.png" : ":/images/unknownfolder.png");
+
+        QString overlay;
+        if (state == Conflicted)
+            overlay = ":/images/conflictedfile.png";
+        else if (state == Modified)
+            overlay = ":/images/modifiedfile.png";
+        else if (state == Unversioned)
+            overlay = ":/images/unknownfile.png";
+
+        if (!overlay.isEmpty())
         {
-            _result = itemFromDirectory(dir, item(i));
-            if (_result)
-                return _result;
+            QPixmap emblem = QPixmap(overlay).scaled(folder.size() / 2, Qt::KeepAspectRatio,
+                                                     Qt::SmoothTransformation);
+            QPainter painter(&folder);
+            painter.drawPixmap(folder.width() - emblem.width(), folder.height() - emblem.height(), emblem);
         }
+        icons.insert(key, QIcon(folder));
     }
-
-    return 0;
+    return icons.value(key);
 }
@@ -21,9 +21,18 @@
 #ifndef WCMODEL_H
 #define WCMODEL_H
 
+//SvnQt
+#include "svnqt/status.hpp"
+
 //Qt
+#include <QHash>
+#include <QMultiHash>
+#include <QSet>
 #include <QStandardItemModel>
 
+class QSvnClientStatusAction;
+class WcDirectoryLoader;
+
 
 class WcModel : public QStandardItemModel
 {
@@ -34,25 +43,96 @@ class WcModel : public QStandardItemModel
         ~WcModel();
 
         bool hasChildren(const QModelIndex &parent = QModelIndex()) const;
+        bool canFetchMore(const QModelIndex &parent) const;
+        void fetchMore(const QModelIndex &parent);
 
         void insertWc(QString dir);
         void removeWc(QString dir);
-        void updateWc(QString dir);
         QString getPath(const QModelIndex &index) const;
+        QStringList workingCopies() const;
+
+        /**
+         * Read the status of a working copy in the background and show it with overlay icons.
+         */
+        void scanStatus(QString wc);
+        /**
+         * Read the state of some changed paths again. Added and removed
+         * directories are inserted into or removed from the tree.
+         */
+        void invalidatePaths(const QStringList &paths);
 
     public slots:
         void doCollapse(const QModelIndex &index);
+        /**
+         * Take over the status of some paths, e.g. from the file list.
+         * @param dir Directory the status was read for. Dirty files of dir missing
+         *            in entries are treated as clean.
+         */
+        void updateStatus(const QString &dir, const svn::StatusEntries &entries);
+        /**
+         * Take over the status of single paths. Paths missing in entries are treated as clean.
+         */
+        void updateStatus(const QStringList &paths, const svn::StatusEntries &entries);
+
+    private slots:
+        void onDirsLoaded(const QString &dir, int token, const QStringList &names,
+                          const QStringList &wcNames, const QStringList &leafNames, bool complete);
+        void onWcChecked(const QString &dir, bool isWc, bool hasSubdirs);
+        void onRowsAboutToBeRemoved(const QModelIndex &parent, int start, int end);
+        void onStatusFinished(QString wc);
+        void onPathStatusFinished();
 
     private:
         enum UserRoles
         {
             PathRole = Qt::UserRole + 1,
-            PopulatedRole = Qt::UserRole + 2
+            PopulatedRole = Qt::UserRole + 2,
+            LoadingRole = Qt::UserRole + 3,
+            WcRole = Qt::UserRole + 4
+        };
+
+        enum DirtyState
+        {
+            Modified = 1,
+            Conflicted = 2,
+            Unversioned = 4
+        };
+
+        //number of dirty paths at or below a directory
+        struct DirtyCounts
+        {
+            DirtyCounts() : modified(0), conflicted(0), unversioned(0) {}
+            int modified;
+            int conflicted;
+            int unversioned;
         };
 
-        void insertDir(QString dir, QStandardItem *parent, int row) const;
-        void populate(QStandardItem *parent) const;
-        QStandardItem* itemFromDirectory(const QString dir, const QStandardItem* parent = 0);
+        WcDirectoryLoader *m_loader;
+        QHash<QString, int> m_loadTokens; //token of the running listing of a directory
+        //a directory may be shown more than once, e.g. as favorite and as subdirectory
+        QMultiHash<QString, QStandardItem*> m_itemIndex;
+        //dirty state of single paths and the sums for their parents, all by indexKey()
+        QHash<QString, int> m_pathStates;
+        QHash<QString, QSet<QString> > m_dirtyFiles; //dirty paths other than directories by their parent
+        QHash<QString, DirtyCounts> m_dirtyCounts;
+        QSet<QString> m_statusRoots;
+        QHash<QSvnClientStatusAction*, QStringList> m_pathUpdates; //paths of running status actions
+
+        QStandardItem* insertDir(QString dir, QStandardItem *parent, int row, bool isWc, bool hasSubdirs = true);
+        void populate(QStandardItem *parent);
+        void cancelLoad(QStandardItem *item);
+        QStandardItem* itemFromDirectory(const QString dir) const;
+        QList<QStandardItem*> itemsFromDirectory(const QString dir) const;
+        void unindexItem(QStandardItem *item);
+        static QString indexKey(const QString &dir);
+
+        void setStatus(const QString &wc, const svn::StatusEntries &entries);
+        void setPathState(const QString &key, int state, bool isDir = false);
+        bool isUnderStatusRoot(const QString &key) const;
+        void updateIcon(QStandardItem *item);
+        static int dirtyState(const svn::StatusPtr status);
+        static bool isDirectory(const svn::StatusPtr status);
+        static QIcon folderIcon(bool isWc, int state);
 
         void saveWcList();
         void loadWcList();